@@ -30,39 +30,26 @@
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 
-#include "MovingAverage.h"
-using namespace rohrah;
+#include "AFMotor.h"
+#include "Board.h"
 
-/**
- * Constructor
- * Defines a sliding window with all values in the window initialized to defaultVal
- * The window's size is equal to length
- * Average of the values within this sliding window is calculated
- */
-MovingAverage::MovingAverage(int defaultVal, int length): size(length), index(0), sum(0) {
-  buffer = new int[size];
-  for (int i=0; i<size; i++) {
-    buffer[i] = defaultVal;
-    sum += buffer[i];
-  }
+using sim::Board;
+
+AF_DCMotor::AF_DCMotor(uint8_t number, uint8_t): motorNumber(number) {
+  Board::current().motor(motorNumber).latchWrites++;
 }
 
 /**
- * Destructor
+ * Every run() shifts a new byte out to the latch, whether or not it changed
  */
-MovingAverage::~MovingAverage(){
-  delete buffer;
+void AF_DCMotor::run(uint8_t cmd) {
+  sim::MotorPort &port = Board::current().motor(motorNumber);
+  port.command = cmd;
+  port.latchWrites++;
 }
 
-/**
- * Adds newValue to the sliding window and removes the oldest value
- * Returns the newly calculated moving average
- */
-int MovingAverage::add(int newValue) {  
-    sum = sum - buffer[index] + newValue;
-    buffer[index++] = newValue;
-    if (index >= size) {
-      index = 0;
-    }
-    return (sum / size);
-}
+void AF_DCMotor::setSpeed(uint8_t speed) {
+  sim::MotorPort &port = Board::current().motor(motorNumber);
+  port.pwm = speed;
+  port.speedWrites++;
+}
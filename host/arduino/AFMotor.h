@@ -0,0 +1,66 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _AF_MOTOR_H_
+#define _AF_MOTOR_H_
+
+#include <Arduino.h>
+
+#define MOTOR12_64KHZ 1
+#define MOTOR12_8KHZ 2
+#define MOTOR12_2KHZ 3
+#define MOTOR12_1KHZ 4
+#define MOTOR34_64KHZ 1
+#define MOTOR34_8KHZ 2
+#define MOTOR34_1KHZ 3
+
+#define FORWARD 1
+#define BACKWARD 2
+#define BRAKE 3
+#define RELEASE 4
+
+/**
+ * Host stand-in for the Adafruit motor shield V1 library.
+ * Drives a motor channel of the simulated board and counts the PWM register writes
+ * and the 74HC595 latch updates the real library would do.
+ */
+class AF_DCMotor {
+  public:
+    AF_DCMotor(uint8_t motorNumber, uint8_t freq = MOTOR34_8KHZ);
+    void run(uint8_t cmd);
+    void setSpeed(uint8_t speed);
+
+  private:
+    uint8_t motorNumber;
+};
+
+#endif
@@ -0,0 +1,213 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "Arduino.h"
+#include "avr/sleep.h"
+#include "Board.h"
+
+using sim::Board;
+
+#define SERIAL_TX_BUFFER_SIZE 64
+
+HardwareSerial Serial;
+
+unsigned long millis() {
+  return Board::current().millis();
+}
+
+unsigned long micros() {
+  return Board::current().micros();
+}
+
+void delay(unsigned long ms) {
+  Board::current().advance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  Board::current().advance(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  Board::current().pinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  Board::current().digitalWrite(pin, val);
+}
+
+int digitalRead(uint8_t pin) {
+  return Board::current().digitalRead(pin);
+}
+
+int analogRead(uint8_t pin) {
+  return Board::current().analogRead(pin);
+}
+
+void analogWrite(uint8_t pin, int val) {
+  Board::current().digitalWrite(pin, val > 127 ? HIGH : LOW);
+}
+
+/**
+ * Same arithmetic as WMath.cpp in the Arduino core
+ */
+long random(long howbig) {
+  if (howbig == 0)
+    return 0;
+  return Board::current().random() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig)
+    return howsmall;
+  long diff = howbig - howsmall;
+  return random(diff) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0)
+    Board::current().randomSeed(seed);
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode) {
+  Board::current().attachInterrupt(interruptNum, userFunc, mode);
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+  Board::current().attachInterrupt(interruptNum, 0, 0);
+}
+
+void noInterrupts() {
+}
+
+void interrupts() {
+}
+
+static thread_local bool sleepEnabled = false;
+
+void set_sleep_mode(uint8_t /*mode*/) {
+}
+
+void sleep_enable() {
+  sleepEnabled = true;
+}
+
+void sleep_disable() {
+  sleepEnabled = false;
+}
+
+/**
+ * Like the SLEEP instruction, does nothing unless sleep_enable() has been called
+ */
+void sleep_cpu() {
+  if (sleepEnabled)
+    Board::current().sleep();
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    if (write(*buffer++))
+      n++;
+    else
+      break;
+  }
+  return n;
+}
+
+size_t Print::print(long n, int base) {
+  if (n < 0 && base == DEC) {
+    size_t t = print('-');
+    return t + print((unsigned long)(-n), base);
+  }
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2)
+    base = 10;
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(str);
+}
+
+void HardwareSerial::begin(unsigned long baud) {
+  Board::current().usb.baud = baud;
+}
+
+int HardwareSerial::available() {
+  return (int)Board::current().usb.rx.size();
+}
+
+int HardwareSerial::read() {
+  sim::SerialPort &port = Board::current().usb;
+  if (port.rx.empty())
+    return -1;
+  int b = port.rx.front();
+  port.rx.pop_front();
+  return b;
+}
+
+int HardwareSerial::peek() {
+  sim::SerialPort &port = Board::current().usb;
+  return port.rx.empty() ? -1 : port.rx.front();
+}
+
+/**
+ * Room left in the transmit buffer, which drains at the configured baud rate
+ */
+int HardwareSerial::availableForWrite() {
+  Board &board = Board::current();
+  int room = SERIAL_TX_BUFFER_SIZE - 1 - board.usb.txQueued(board.now());
+  return room < 0 ? 0 : room;
+}
+
+/**
+ * Like the real HardwareSerial, blocks while the transmit buffer is full
+ */
+size_t HardwareSerial::write(uint8_t b) {
+  Board &board = Board::current();
+  sim::SerialPort &port = board.usb;
+  uint64_t t = port.byteTime();
+  if (t > 0) {
+    if (port.txQueued(board.now()) >= SERIAL_TX_BUFFER_SIZE - 1)
+      board.advance(port.txBusyUntil - (SERIAL_TX_BUFFER_SIZE - 2) * t - board.now());
+    port.txBusyUntil = (port.txBusyUntil > board.now() ? port.txBusyUntil : board.now()) + t;
+  }
+  port.deliver(b);
+  return 1;
+}
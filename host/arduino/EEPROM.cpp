@@ -0,0 +1,58 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "EEPROM.h"
+#include "Board.h"
+
+using sim::Board;
+
+EEPROMClass EEPROM;
+
+uint8_t EEPROMClass::read(int address) {
+  return Board::current().eepromRead(address);
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  Board::current().eepromWrite(address, value);
+}
+
+/**
+ * Write only if the value differs, which spares the cells' limited erase cycles
+ */
+void EEPROMClass::update(int address, uint8_t value) {
+  if (read(address) != value)
+    write(address, value);
+}
+
+uint16_t EEPROMClass::length() {
+  return sim::Board::EEPROM_SIZE;
+}
@@ -0,0 +1,52 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _EEPROM_H_
+#define _EEPROM_H_
+
+#include <Arduino.h>
+
+/**
+ * Host stand-in for the Arduino EEPROM library.
+ * The bytes live on the simulated board, 1KB like the Uno's, erased to 0xFF.
+ */
+class EEPROMClass {
+  public:
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    void update(int address, uint8_t value);
+    uint16_t length();
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,90 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "NewPing.h"
+#include "Board.h"
+
+using sim::Board;
+
+#define TRIGGER_TIME 14     //trigger pulse plus the low time before it
+#define ECHO_START_DELAY 450 //time the sensor takes to send the burst and raise echo
+
+/**
+ * Same limits as the real library: the range is capped at MAX_SENSOR_DISTANCE
+ */
+NewPing::NewPing(uint8_t triggerPin, uint8_t echoPin, unsigned int maxCmDistance): trigger(triggerPin), echo(echoPin) {
+  if (maxCmDistance > MAX_SENSOR_DISTANCE)
+    maxCmDistance = MAX_SENSOR_DISTANCE;
+  maxEchoTime = maxCmDistance * US_ROUNDTRIP_CM + (US_ROUNDTRIP_CM / 2);
+}
+
+/**
+ * Blocking ping.  Returns the echo time in microseconds, or NO_ECHO if nothing is in range.
+ * Either way the virtual clock moves on by as long as the real sensor would have taken
+ */
+unsigned int NewPing::ping(unsigned int maxCmDistance) {
+  unsigned int maxTime = maxEchoTime;
+  if (maxCmDistance > 0 && maxCmDistance < MAX_SENSOR_DISTANCE)
+    maxTime = maxCmDistance * US_ROUNDTRIP_CM + (US_ROUNDTRIP_CM / 2);
+  Board &board = Board::current();
+  board.countPing();
+  board.advance(TRIGGER_TIME + ECHO_START_DELAY);
+  double cm = board.rangeCm(trigger, maxTime / (double)US_ROUNDTRIP_CM + 1);
+  unsigned int echoTime = (unsigned int)(cm * US_ROUNDTRIP_CM);
+  if (echoTime >= maxTime) {
+    board.advance(maxTime);
+    return NO_ECHO;
+  }
+  board.advance(echoTime);
+  return echoTime;
+}
+
+unsigned long NewPing::ping_cm(unsigned int maxCmDistance) {
+  return convert_cm(ping(maxCmDistance));
+}
+
+unsigned long NewPing::ping_in(unsigned int maxCmDistance) {
+  return convert_in(ping(maxCmDistance));
+}
+
+/**
+ * Rounded conversion as in NewPingConvert(), a non-zero echo never converts to zero
+ */
+unsigned int NewPing::convert_cm(unsigned int echoTime) {
+  unsigned int cm = (echoTime + US_ROUNDTRIP_CM / 2) / US_ROUNDTRIP_CM;
+  return (cm == 0 && echoTime) ? 1 : cm;
+}
+
+unsigned int NewPing::convert_in(unsigned int echoTime) {
+  unsigned int in = (echoTime + US_ROUNDTRIP_IN / 2) / US_ROUNDTRIP_IN;
+  return (in == 0 && echoTime) ? 1 : in;
+}
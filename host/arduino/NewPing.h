@@ -0,0 +1,64 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _NEW_PING_H_
+#define _NEW_PING_H_
+
+#include <Arduino.h>
+
+#define MAX_SENSOR_DISTANCE 500
+#define US_ROUNDTRIP_CM 57
+#define US_ROUNDTRIP_IN 146
+#define NO_ECHO 0
+#define MAX_SENSOR_DELAY 5800
+
+/**
+ * Host stand-in for the NewPing library.
+ * A ping asks the simulated board how far the world is from the sensor and blocks
+ * the virtual clock for as long as the real sensor would.
+ */
+class NewPing {
+  public:
+    NewPing(uint8_t triggerPin, uint8_t echoPin, unsigned int maxCmDistance = MAX_SENSOR_DISTANCE);
+    unsigned int ping(unsigned int maxCmDistance = 0);
+    unsigned long ping_cm(unsigned int maxCmDistance = 0);
+    unsigned long ping_in(unsigned int maxCmDistance = 0);
+    static unsigned int convert_cm(unsigned int echoTime);
+    static unsigned int convert_in(unsigned int echoTime);
+
+  private:
+    uint8_t trigger;
+    uint8_t echo;
+    unsigned int maxEchoTime;
+};
+
+#endif
@@ -0,0 +1,73 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "SoftwareSerial.h"
+#include "Board.h"
+
+using sim::Board;
+
+SoftwareSerial::SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool): rxPin(receivePin), txPin(transmitPin) {
+}
+
+void SoftwareSerial::begin(long speed) {
+  Board::current().bluetooth.baud = speed;
+}
+
+int SoftwareSerial::available() {
+  return (int)Board::current().bluetooth.rx.size();
+}
+
+int SoftwareSerial::read() {
+  sim::SerialPort &port = Board::current().bluetooth;
+  if (port.rx.empty())
+    return -1;
+  int b = port.rx.front();
+  port.rx.pop_front();
+  return b;
+}
+
+int SoftwareSerial::peek() {
+  sim::SerialPort &port = Board::current().bluetooth;
+  return port.rx.empty() ? -1 : port.rx.front();
+}
+
+/**
+ * SoftwareSerial bit-bangs each byte with interrupts off, so the caller is blocked
+ * for the full ten bit times of the frame
+ */
+size_t SoftwareSerial::write(uint8_t b) {
+  sim::SerialPort &port = Board::current().bluetooth;
+  if (port.baud > 0)
+    Board::current().advance(10000000UL / port.baud);
+  port.deliver(b);
+  return 1;
+}
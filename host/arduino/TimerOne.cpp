@@ -0,0 +1,83 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "TimerOne.h"
+#include "Board.h"
+
+using sim::Board;
+
+TimerOne Timer1;
+
+/**
+ * Set the period and start counting
+ */
+void TimerOne::initialize(unsigned long microseconds) {
+  Board &board = Board::current();
+  board.setTimer(microseconds, board.getTimerHandler(), true);
+}
+
+void TimerOne::setPeriod(unsigned long microseconds) {
+  Board &board = Board::current();
+  board.setTimer(microseconds, board.getTimerHandler(), board.isTimerRunning());
+}
+
+void TimerOne::attachInterrupt(void (*isr)()) {
+  Board &board = Board::current();
+  board.setTimer(board.getTimerPeriod(), isr, board.isTimerRunning());
+}
+
+void TimerOne::detachInterrupt() {
+  Board &board = Board::current();
+  board.setTimer(board.getTimerPeriod(), 0, board.isTimerRunning());
+}
+
+/**
+ * Start over from the beginning of a period
+ */
+void TimerOne::start() {
+  Board &board = Board::current();
+  board.setTimer(board.getTimerPeriod(), board.getTimerHandler(), true);
+}
+
+void TimerOne::stop() {
+  Board &board = Board::current();
+  board.setTimer(board.getTimerPeriod(), board.getTimerHandler(), false);
+}
+
+/**
+ * Carry on after stop().  The board does not keep the part of the period that had gone
+ * by, so this is start()
+ */
+void TimerOne::resume() {
+  start();
+}
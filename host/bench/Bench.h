@@ -0,0 +1,105 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Tiny helpers shared by the host benchmarks.
+ * Costs are in TSC cycles on x86 and in nanoseconds elsewhere.  They compare
+ * implementations with each other on the host; they are not AVR cycle counts.
+ */
+namespace bench {
+
+  inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  inline const char *unit() {
+#if defined(__x86_64__) || defined(__i386__)
+    return "cycles";
+#else
+    return "ns";
+#endif
+  }
+
+  /**
+   * Best of several runs of body(i) for i in [0, iterations), as cost per call
+   */
+  template <typename F>
+  double perCall(F body, unsigned long iterations, int runs = 5) {
+    for (unsigned long i = 0; i < iterations / 10; i++)
+      body(i);
+    double best = 1e300;
+    for (int r = 0; r < runs; r++) {
+      uint64_t start = now();
+      for (unsigned long i = 0; i < iterations; i++)
+        body(i);
+      double cost = (double)(now() - start) / iterations;
+      if (cost < best)
+        best = cost;
+    }
+    return best;
+  }
+
+  /**
+   * Keep the optimizer from throwing a result away
+   */
+  template <typename T>
+  inline void keep(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+  }
+
+  /**
+   * Small deterministic generator for benchmark inputs
+   */
+  inline uint32_t xorshift(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+}
+
+#endif
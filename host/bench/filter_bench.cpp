@@ -0,0 +1,117 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <vector>
+
+#include "Bench.h"
+#include "MovingAverage.h"
+#include "MedianFilter.h"
+#include "ExponentialMovingAverage.h"
+
+using namespace rohrah;
+
+/**
+ * The MovingAverage the firmware used to have: heap allocated window,
+ * runtime length and a division on every add()
+ */
+class HeapMovingAverage {
+  public:
+    HeapMovingAverage(int defaultVal, int length): size(length), index(0), sum(0) {
+      buffer = new int[size];
+      for (int i = 0; i < size; i++) {
+        buffer[i] = defaultVal;
+        sum += buffer[i];
+      }
+    }
+    ~HeapMovingAverage() { delete[] buffer; }
+    int add(int newValue) {
+      sum = sum - buffer[index] + newValue;
+      buffer[index++] = newValue;
+      if (index >= size)
+        index = 0;
+      return sum / size;
+    }
+  private:
+    int *buffer;
+    int size;
+    int index;
+    int sum;
+};
+
+#define ITERATIONS 10000000UL
+#define SAMPLES 4096 //power of two
+
+static std::vector<unsigned int> samples;
+
+template <typename Filter>
+static void run(const char *name, Filter &filter) {
+  double cost = bench::perCall([&](unsigned long i) {
+    bench::keep(filter.add(samples[i & (SAMPLES - 1)]));
+  }, ITERATIONS);
+  printf("%-40s %6.2f %s/add  %5u bytes\n", name, cost, bench::unit(), (unsigned)sizeof(Filter));
+}
+
+/**
+ * Cost of one add() for each distance filter, fed ultrasonic-like readings:
+ * a slowly changing distance with noise and the odd missed echo
+ */
+int main() {
+  uint32_t seed = 12345;
+  for (int i = 0; i < SAMPLES; i++) {
+    unsigned int d = 50 + (i % 512) / 4 + bench::xorshift(seed) % 5;
+    if (bench::xorshift(seed) % 50 == 0)
+      d = 600;
+    samples.push_back(d);
+  }
+
+  HeapMovingAverage heap10(100, 10);
+  MovingAverage<unsigned int, 10> window10(100);
+  MovingAverage<unsigned int, 8> window8(100);
+  MovingAverage<unsigned int, 16, unsigned long> window16(100);
+  MovingAverage<unsigned char, 8, unsigned int> window8byte(100);
+  MedianFilter<unsigned int, 5> median5(100);
+  MedianFilter<unsigned int, 9> median9(100);
+  ExponentialMovingAverage<unsigned int, 2> ema2(100);
+  ExponentialMovingAverage<unsigned int, 3> ema3(100);
+
+  printf("filter                                   cost        size (host)\n");
+  run("heap MovingAverage(10), old", heap10);
+  run("MovingAverage<unsigned int, 10>", window10);
+  run("MovingAverage<unsigned int, 8>", window8);
+  run("MovingAverage<unsigned int, 16, ulong>", window16);
+  run("MovingAverage<unsigned char, 8, uint>", window8byte);
+  run("MedianFilter<unsigned int, 5>", median5);
+  run("MedianFilter<unsigned int, 9>", median9);
+  run("ExponentialMovingAverage<uint, 2>", ema2);
+  run("ExponentialMovingAverage<uint, 3>", ema3);
+  return 0;
+}
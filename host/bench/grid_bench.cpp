@@ -0,0 +1,127 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <math.h>
+#include <vector>
+
+#include "Bench.h"
+#include "OccupancyGrid.h"
+
+using namespace rohrah;
+
+/**
+ * The obvious way to do it: a byte per cell and the ray marched in half cell steps
+ * with floating point sin() and cos()
+ */
+class FloatGrid {
+  public:
+    FloatGrid() { for (int i = 0; i < 32 * 32; i++) cells[i] = 0; }
+    void update(int x, int y, unsigned int bearing, unsigned int cm, bool echo) {
+      float angle = bearing * (float)(2 * M_PI / 65536);
+      float dx = cosf(angle) * 8, dy = sinf(angle) * 8;
+      int steps = cm / 8;
+      int last = -1;
+      for (int i = 1; i <= steps; i++) {
+        int column = (int)floorf((x + dx * i) / 16) + 16;
+        int row = (int)floorf((y + dy * i) / 16) + 16;
+        if (column < 0 || column >= 32 || row < 0 || row >= 32)
+          break;
+        int cell = row * 32 + column;
+        if (cell == last)
+          continue;
+        last = cell;
+        if (echo && i == steps) {
+          if (cells[cell] < 3)
+            cells[cell]++;
+        }
+        else if (cells[cell] > 0) {
+          cells[cell]--;
+        }
+      }
+    }
+  private:
+    unsigned char cells[32 * 32];
+};
+
+#define ITERATIONS 2000000UL
+#define PINGS 4096 //power of two
+
+struct Ping {
+  int x, y;
+  unsigned int bearing;
+  unsigned int cm;
+  bool echo;
+};
+
+static std::vector<Ping> pings;
+
+template <typename Grid>
+static void run(const char *name, Grid &grid) {
+  double cost = bench::perCall([&](unsigned long i) {
+    const Ping &p = pings[i & (PINGS - 1)];
+    grid.update(p.x, p.y, p.bearing, p.cm, p.echo);
+    bench::keep(grid);
+  }, ITERATIONS);
+  printf("%-40s %7.1f %s/ping  %5u bytes\n", name, cost, bench::unit(), (unsigned)sizeof(Grid));
+}
+
+/**
+ * Cost of adding one ultrasonic sample to the obstacle map, and of asking it whether a
+ * direction is blocked, for pings like the robot's: taken from anywhere within a couple
+ * of metres of the start, 10 to 200cm long, most of them with an echo
+ */
+int main() {
+  uint32_t seed = 12345;
+  for (int i = 0; i < PINGS; i++) {
+    Ping p;
+    p.x = (int)(bench::xorshift(seed) % 400) - 200;
+    p.y = (int)(bench::xorshift(seed) % 300) - 150;
+    p.bearing = bench::xorshift(seed) & 0xFFFF;
+    p.cm = 10 + bench::xorshift(seed) % 190;
+    p.echo = bench::xorshift(seed) % 4 != 0;
+    pings.push_back(p);
+  }
+
+  OccupancyGrid<32, 4> grid;
+  FloatGrid floatGrid;
+
+  printf("map                                      cost           size (host)\n");
+  run("OccupancyGrid<32, 4>, 2 bit Bresenham", grid);
+  run("byte per cell, float ray march", floatGrid);
+
+  double query = bench::perCall([&](unsigned long i) {
+    const Ping &p = pings[i & (PINGS - 1)];
+    bench::keep(grid.isBlocked(p.x, p.y, p.bearing, 70));
+  }, ITERATIONS);
+  printf("%-40s %7.1f %s/query\n", "OccupancyGrid<32, 4>::isBlocked(70cm)", query, bench::unit());
+  return 0;
+}
@@ -0,0 +1,140 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <cmath>
+#include <vector>
+
+#include "Bench.h"
+#include "Odometry.h"
+#include "Trig.h"
+
+using namespace rohrah;
+
+/**
+ * Odometry as it would be written in floating point: the same model, sin() and cos()
+ */
+template <typename Real>
+class RealOdometry {
+  public:
+    RealOdometry(Real maxSpeed, Real deadband, Real wheelBase):
+      maxSpeed(maxSpeed), deadband(deadband), wheelBase(wheelBase), x(0), y(0), heading(0) {}
+    void update(int leftOutput, int rightOutput, unsigned long dt) {
+      Real left = wheelSpeed(leftOutput), right = wheelSpeed(rightOutput);
+      Real seconds = dt / (Real)1000;
+      Real turn = (right - left) / wheelBase * seconds;
+      Real mid = heading + turn / 2;
+      Real distance = (left + right) / 2 * seconds;
+      x += distance * std::cos(mid);
+      y += distance * std::sin(mid);
+      heading = std::fmod(heading + turn + 2 * (Real)M_PI, 2 * (Real)M_PI);
+    }
+    Real getX() const { return x; }
+    Real getY() const { return y; }
+    Real getHeading() const { return heading; } //radians
+  private:
+    Real wheelSpeed(int output) const {
+      Real magnitude = output < 0 ? -output : output;
+      if (magnitude <= deadband)
+        return 0;
+      Real speed = maxSpeed * (magnitude - deadband) / (255 - deadband);
+      return output < 0 ? -speed : speed;
+    }
+    Real maxSpeed, deadband, wheelBase;
+    Real x, y, heading;
+};
+
+#define ITERATIONS 5000000UL
+#define COMMANDS 4096 //power of two
+#define STEP 20 //ms, the control period
+
+struct Outputs {
+  int left, right;
+};
+
+static std::vector<Outputs> commands;
+
+static void report(const char *name, double x, double y, double heading, const RealOdometry<double> &reference) {
+  double apart = std::hypot(x - reference.getX(), y - reference.getY());
+  double turned = std::fabs(std::remainder(heading - reference.getHeading(), 2 * M_PI)) * 180 / M_PI;
+  printf("%-40s %6.2f cm %6.3f deg\n", name, apart, turned);
+}
+
+/**
+ * Cost of one odometry update, fixed point against float, for motor outputs like those of
+ * auto mode: mostly driving ahead, now and then spinning in place.  Then how far the two
+ * part after ten minutes of driving
+ */
+int main() {
+  uint32_t seed = 12345;
+  for (int i = 0; i < COMMANDS; i++) {
+    Outputs o;
+    int kind = bench::xorshift(seed) % 8;
+    int speed = 100 + bench::xorshift(seed) % 156;
+    o.left = kind == 0 ? -255 : speed;
+    o.right = kind == 1 ? -255 : speed - (int)(bench::xorshift(seed) % 20);
+    commands.push_back(o);
+  }
+
+  Odometry fixed(60, 70, 14);
+  RealOdometry<float> floating(60, 70, 14);
+  unsigned long time = 0;
+  double fixedCost = bench::perCall([&](unsigned long i) {
+    const Outputs &o = commands[i & (COMMANDS - 1)];
+    fixed.update(o.left, o.right, time += STEP);
+    bench::keep(fixed);
+  }, ITERATIONS);
+  double floatCost = bench::perCall([&](unsigned long i) {
+    const Outputs &o = commands[i & (COMMANDS - 1)];
+    floating.update(o.left, o.right, STEP);
+    bench::keep(floating);
+  }, ITERATIONS);
+  printf("odometry update                          cost\n");
+  printf("%-40s %6.1f %s\n", "Odometry, Q24.8 / Q16.16 fixed point", fixedCost, bench::unit());
+  printf("%-40s %6.1f %s\n", "float, sinf() and cosf()", floatCost, bench::unit());
+
+  //drift, following the same ten minutes of commands, each for twenty periods in a row
+  Odometry drift(60, 70, 14);
+  RealOdometry<float> floatDrift(60, 70, 14);
+  RealOdometry<double> reference(60, 70, 14);
+  time = 0;
+  drift.update(0, 0, time);
+  for (unsigned long i = 0; i < 10 * 60 * 1000 / STEP; i++) {
+    const Outputs &o = commands[(i / 20) & (COMMANDS - 1)];
+    drift.update(o.left, o.right, time += STEP);
+    floatDrift.update(o.left, o.right, STEP);
+    reference.update(o.left, o.right, STEP);
+  }
+  printf("\nafter 10 minutes of driving, away from the same in double\n");
+  report("Odometry", drift.getX(), drift.getY(), drift.getHeading() * 2 * M_PI / 65536, reference);
+  report("float", floatDrift.getX(), floatDrift.getY(), floatDrift.getHeading(), reference);
+  return 0;
+}
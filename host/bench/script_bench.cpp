@@ -0,0 +1,331 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Arena.h"
+#include "Board.h"
+#include "Layout.h"
+#include "Robot.h"
+#include "Transport.h"
+#include "MotionAssembler.h"
+
+using namespace rohrah;
+using sim::Arena;
+using sim::Board;
+using sim::MotorPort;
+
+/**
+ * The robot without wheel encoders, so that the motor outputs only change when a command
+ * or a script changes them, and the bench can see when that happens
+ */
+struct BenchConfig : StandardConfig {
+  typedef NoWheelSpeedControl SpeedControl;
+};
+typedef Robot<BenchConfig> BenchRobot;
+
+#define BT_BAUD 9600 //as in rohrahrobot.ino
+#define START 2000 //ms, when the manoeuvre starts, the upload goes a second earlier
+#define BYTE_TIME 1.04 //ms per byte on the link at 9600 baud
+
+//forward, a quarter turn, four times, then a pause
+static const char *defaultScript =
+  "repeat 4\n"
+  "  drive 200 200 800\n"
+  "  drive -200 200 450\n"
+  "next\n"
+  "stop 300\n";
+
+/**
+ * A change of speeds the script makes, in ms from its start
+ */
+struct Segment {
+  unsigned long at;
+  int left;
+  int right;
+};
+
+/**
+ * What one run of a manoeuvre did
+ */
+struct Run {
+  double start; //ms from when it was asked for to the first change of the outputs
+  std::vector<double> errors; //ms each later change came after or before its time, counted from the first
+  double x, y, heading; //where the robot ended up
+  long reportedLate; //us mean and worst the robot itself reported, -1 without a report
+  long reportedMax;
+};
+
+/**
+ * The changes of speed the script makes, by running through it.  Waits on the sensors
+ * have no time of their own, so the bench does not take scripts with them
+ */
+static bool plan(const std::vector<unsigned char> &code, std::vector<Segment> &segments) {
+  struct Loop { size_t start; int count; };
+  std::vector<Loop> loops;
+  unsigned long time = 0;
+  int left, right;
+  for (size_t pc = 0; pc < code.size(); ) {
+    const unsigned char *p = &code[pc];
+    switch (*p) {
+      case MotionScript::opEnd:
+      case MotionScript::opDrive:
+        left = *p == MotionScript::opEnd ? 0 : readInt16(p + 1);
+        right = *p == MotionScript::opEnd ? 0 : readInt16(p + 3);
+        if (segments.empty() ? left || right : segments.back().left != left || segments.back().right != right)
+          segments.push_back({ time, left, right });
+        if (*p == MotionScript::opEnd)
+          return !segments.empty();
+        time += readUint16(p + 5);
+        break;
+      case MotionScript::opRepeat:
+        if (p[1] == 0)
+          return false;
+        loops.push_back({ pc + 2, p[1] });
+        break;
+      case MotionScript::opNext:
+        if (--loops.back().count > 0) {
+          pc = loops.back().start;
+          continue;
+        }
+        loops.pop_back();
+        break;
+      default:
+        return false;
+    }
+    pc += MotionScript::size(*p);
+  }
+  return false;
+}
+
+static std::string driveFrame(int left, int right) {
+  unsigned char payload[5];
+  unsigned char frame[5 + FRAME_OVERHEAD];
+  payload[0] = RemoteControlCommand::moveCommand;
+  writeInt16(payload + 1, left);
+  writeInt16(payload + 3, right);
+  return std::string((const char *)frame, encodeFrame(frame, FRAME_DRIVE, payload, sizeof(payload)));
+}
+
+/**
+ * One robot on a board of its own.  Scripted, the script is uploaded and started with
+ * 'S'.  Interactively, a FRAME_DRIVE goes out at the time of each change, the way a
+ * remote control would send it.  Either way what the robot is sent is late by a delay
+ * drawn from minLatency to maxLatency ms, plus the time the bytes take on the link
+ */
+static Run manoeuvre(const std::vector<unsigned char> &code, const std::vector<Segment> &segments, bool scripted,
+                     double minLatency, double maxLatency, unsigned long seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> latency(minLatency, maxLatency);
+  Board board;
+  Board::setCurrent(&board);
+  Arena arena(1000, 1000);
+  arena.place(500, 500, 0);
+  board.attachArena(&arena);
+  sim::wireRobot(board);
+  std::string received;
+  board.usb.onWrite = [](uint8_t) {};
+  board.bluetooth.onWrite = [&received](uint8_t b) { received += (char)b; };
+
+  Run run;
+  std::vector<double> changes; //ms
+  {
+    SoftwareSerial serial(BenchConfig::BT_RX_PIN, BenchConfig::BT_TX_PIN);
+    SoftwareSerialTransport link(serial);
+    BenchRobot robot(&link);
+    Serial.begin(9600);
+    link.begin(BT_BAUD);
+    robot.begin();
+
+    auto send = [&](unsigned long at, const std::string &bytes) {
+      double delay = latency(rng) + bytes.size() * BYTE_TIME;
+      board.inject(board.bluetooth, (uint64_t)((at + delay) * 1000), bytes);
+    };
+    if (scripted) {
+      board.inject(board.bluetooth, (START - 1000) * 1000ULL, tools::scriptFrames(code));
+      send(START, "S");
+    }
+    else {
+      for (const Segment &s : segments)
+        send(START + s.at, driveFrame(s.left, s.right));
+    }
+
+    //when the outputs start heading for the speeds of each segment
+    MotorPort &left = board.motor(BenchConfig::LEFT_MOTOR_NUMBER);
+    MotorPort &right = board.motor(BenchConfig::RIGHT_MOTOR_NUMBER);
+    uint64_t end = (START + segments.back().at + 1000 + (uint64_t)maxLatency + 100) * 1000;
+    size_t next = 0;
+    bool settled = true;
+    while (board.now() < end) {
+      robot.run();
+      board.advance(100);
+      if (next >= segments.size())
+        continue;
+      const Segment &previous = next ? segments[next - 1] : Segment{ 0, 0, 0 };
+      if (!settled) {
+        settled = left.output() == previous.left && right.output() == previous.right;
+        continue;
+      }
+      if (left.output() != previous.left || right.output() != previous.right) {
+        changes.push_back(board.now() / 1000.0);
+        next++;
+        settled = false;
+      }
+    }
+    run.x = arena.getX() - 500;
+    run.y = arena.getY() - 500;
+    run.heading = remainder(arena.getHeading(), 360);
+  }
+  Board::setCurrent(0);
+
+  run.start = changes.empty() ? NAN : changes[0] - START;
+  for (size_t i = 1; i < changes.size(); i++)
+    run.errors.push_back((changes[i] - changes[0]) - (double)(segments[i].at - segments[0].at));
+  run.reportedLate = run.reportedMax = -1;
+  size_t header = received.rfind("script segments late max");
+  if (header != std::string::npos) {
+    std::istringstream report(received.substr(header));
+    std::string line, state;
+    unsigned long count;
+    std::getline(report, line);
+    report >> state >> count >> run.reportedLate >> run.reportedMax;
+  }
+  return run;
+}
+
+static void usage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "      --script FILE      manoeuvre to time instead of the built in one, without waits\n"
+    "      --runs N           runs per path, each with its own link delays (default 20)\n"
+    "      --latency MIN:MAX  ms a command takes to reach the robot over Bluetooth, besides\n"
+    "                         the bytes' own time (default 10:60)\n", name);
+}
+
+/**
+ * Timing of a manoeuvre run as a motion script against the same manoeuvre sent as a
+ * FRAME_DRIVE per change of speed, the interactive path, over a link with a random delay.
+ * For each path: how long the robot took to start, how far off the changes after the
+ * first were from where they should be, and how much the final pose varies from run to
+ * run.  Scripted, it also gives the lateness the robot reports itself, which is what is
+ * left once the link is out of the way
+ *
+ * usage: script_bench [--script FILE] [--runs N] [--latency MIN:MAX]
+ */
+int main(int argc, char **argv) {
+  std::string text = defaultScript;
+  int runs = 20;
+  double minLatency = 10, maxLatency = 60;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--script" && hasValue) {
+      std::ifstream file(argv[++i]);
+      std::stringstream contents;
+      contents << file.rdbuf();
+      text = contents.str();
+    }
+    else if (arg == "--runs" && hasValue)
+      runs = atoi(argv[++i]);
+    else if (arg == "--latency" && hasValue && sscanf(argv[i + 1], "%lf:%lf", &minLatency, &maxLatency) == 2)
+      i++;
+    else {
+      usage(argv[0]);
+      return arg == "-h" || arg == "--help" ? 0 : 1;
+    }
+  }
+
+  std::vector<unsigned char> code;
+  std::vector<Segment> segments;
+  std::string error;
+  std::istringstream in(text);
+  if (!tools::assembleScript(in, code, error)) {
+    fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  if (code.size() > BenchConfig::SCRIPT_SIZE || !plan(code, segments)) {
+    fprintf(stderr, "the script has to fit in %u bytes, with no waits and no endless loops\n",
+            (unsigned)BenchConfig::SCRIPT_SIZE);
+    return 1;
+  }
+
+  printf("%zu changes of speed over %lu ms, %d runs per path, link delay %.0f to %.0f ms plus %.2f ms a byte\n\n",
+         segments.size(), segments.back().at, runs, minLatency, maxLatency, BYTE_TIME);
+  printf("%-12s %9s %9s %11s %10s %10s %9s %12s\n", "path", "start ms", "", "changes ms", "", "", "pose", "robot's own");
+  printf("%-12s %9s %9s %10s %10s %10s %9s %12s\n", "", "mean", "max", "mean |e|", "RMS", "max |e|", "cm, deg", "late, max us");
+  for (int scripted = 1; scripted >= 0; scripted--) {
+    double start = 0, maxStart = 0, absError = 0, squares = 0, maxError = 0;
+    double sx = 0, sy = 0, sh = 0, sxx = 0, syy = 0, shh = 0;
+    long late = 0, maxLate = 0;
+    int errors = 0, missed = 0;
+    for (int r = 0; r < runs; r++) {
+      Run run = manoeuvre(code, segments, scripted, minLatency, maxLatency, r + 1);
+      if (run.errors.size() + 1 != segments.size())
+        missed++;
+      start += run.start;
+      maxStart = std::max(maxStart, run.start);
+      for (double e : run.errors) {
+        absError += fabs(e);
+        squares += e * e;
+        maxError = std::max(maxError, fabs(e));
+        errors++;
+      }
+      sx += run.x;
+      sy += run.y;
+      sh += run.heading;
+      sxx += run.x * run.x;
+      syy += run.y * run.y;
+      shh += run.heading * run.heading;
+      late += run.reportedLate;
+      maxLate = std::max(maxLate, run.reportedMax);
+    }
+    double spread = sqrt(std::max(0.0, (sxx - sx * sx / runs + syy - sy * sy / runs) / runs));
+    double turn = sqrt(std::max(0.0, (shh - sh * sh / runs) / runs));
+    char own[32] = "-";
+    if (scripted)
+      snprintf(own, sizeof(own), "%ld, %ld", late / runs, maxLate);
+    printf("%-12s %9.1f %9.1f %10.2f %10.2f %10.1f %4.1f, %3.1f %12s\n", scripted ? "script" : "interactive",
+           start / runs, maxStart, errors ? absError / errors : 0, errors ? sqrt(squares / errors) : 0, maxError,
+           spread, turn, own);
+    if (missed)
+      printf("  %d runs missed changes of speed\n", missed);
+  }
+  return 0;
+}
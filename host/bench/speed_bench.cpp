@@ -0,0 +1,219 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "Board.h"
+#include "Arena.h"
+#include "Layout.h"
+#include "Motor.h"
+#include "WheelSpeedControl.h"
+#include "RobotConfig.h"
+
+using namespace rohrah;
+using sim::Arena;
+using sim::Board;
+
+typedef StandardConfig Config;
+
+#define SEGMENT 3000 //ms each speed is held for
+#define SETTLE 500 //ms after a change before the tracking error counts
+#define TOLERANCE 0.05 //of the target, the wheel has settled once it stays this close
+
+/**
+ * A motor model of the simulator, see sim::Arena
+ */
+struct Model {
+  const char *name;
+  double rightGain;
+  int rightDeadband;
+  double curve;
+  double battery;
+  double lag; //s
+};
+
+static const Model models[] = {
+  { "nominal", 1, 70, 1, 1, 0 },
+  { "worn (--worn)", 0.85, 95, 0.6, 1, 0 },
+  { "battery at 80%", 1, 70, 1, 0.8, 0 },
+  { "worn, 80ms lag", 0.85, 95, 0.6, 1, 0.08 },
+  { "worn at 80%", 0.85, 95, 0.6, 0.8, 0 },
+};
+static const int NUM_MODELS = sizeof(models) / sizeof(models[0]);
+
+//straight ahead at full speed, at cruise, at crawl, then back at cruise
+static const int speeds[] = { 255, 160, Config::CRAWL_SPEED, -160 };
+static const int NUM_SPEEDS = sizeof(speeds) / sizeof(speeds[0]);
+
+struct Result {
+  double error; //cm/s RMS, of both wheels from the target once settled
+  double mismatch; //cm/s mean, left wheel from the right once settled
+  double settle; //ms mean from a change of speed until both wheels stay within TOLERANCE
+  double drift; //degrees the heading turned through, driving straight all the time
+};
+
+/**
+ * Drive one robot through the speeds, in open or closed loop, and see how well the wheels
+ * keep to the speed of the closed loop target
+ */
+static Result drive(const Model &model, bool closed, int kp, int ki, int kd) {
+  Board board;
+  Board::setCurrent(&board);
+  Arena arena(100000, 1000);
+  arena.place(50000, 500, 0);
+  arena.rightGain = model.rightGain;
+  arena.rightDeadband = model.rightDeadband;
+  arena.curve = model.curve;
+  arena.maxSpeed *= model.battery;
+  arena.lag = model.lag;
+  board.attachArena(&arena);
+  sim::wireRobot(board);
+
+  Result result = { 0, 0, 0, 0 };
+  {
+    Motor left(Config::LEFT_MOTOR_NUMBER), right(Config::RIGHT_MOTOR_NUMBER);
+    WheelSpeedControl control(Config::LEFT_ENCODER_PIN, Config::RIGHT_ENCODER_PIN, Config::ENCODER_MAX_RATE,
+                              Config::ENCODER_SAMPLE_INTERVAL, Config::SPEED_CONTROL_INTERVAL);
+    left.setRampRate(Config::MOTOR_RAMP_RATE);
+    right.setRampRate(Config::MOTOR_RAMP_RATE);
+    control.setGains(kp, ki, kd);
+    if (closed)
+      control.start(left, right);
+
+    double squares = 0, mismatch = 0, settle = 0;
+    long samples = 0;
+    for (int s = 0; s < NUM_SPEEDS; s++) {
+      double target = speeds[s] * (double)Config::ENCODER_MAX_RATE / 255 * 100 / Config::ENCODER_TICKS_PER_METER;
+      left.setSpeed(speeds[s]);
+      right.setSpeed(speeds[s]);
+      unsigned long settled = 0;
+      for (unsigned long ms = 0; ms < SEGMENT; ms++) {
+        board.advance(1000);
+        left.update(board.millis());
+        right.update(board.millis());
+        double vl = arena.getWheelSpeed(false), vr = arena.getWheelSpeed(true);
+        if (fabs(vl - target) > fabs(target) * TOLERANCE || fabs(vr - target) > fabs(target) * TOLERANCE)
+          settled = ms + 1;
+        if (ms < SETTLE)
+          continue;
+        squares += (vl - target) * (vl - target) + (vr - target) * (vr - target);
+        mismatch += fabs(vl - vr);
+        samples++;
+      }
+      settle += settled;
+    }
+    result.error = sqrt(squares / (2 * samples));
+    result.mismatch = mismatch / samples;
+    result.settle = settle / NUM_SPEEDS;
+    double turned = fabs(remainder(arena.getHeading(), 360));
+    result.drift = turned;
+  }
+  Board::setCurrent(0);
+  return result;
+}
+
+/**
+ * Sum of the RMS errors over the models, what --tune minimizes
+ */
+static double cost(int kp, int ki, int kd) {
+  double total = 0;
+  for (int m = 0; m < NUM_MODELS; m++)
+    total += drive(models[m], true, kp, ki, kd).error;
+  return total;
+}
+
+static void usage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "      --gains KP:KI:KD  Q8 gains to try instead of RobotConfig.h's\n"
+    "      --tune            search for the gains with the least tracking error over the models\n", name);
+}
+
+/**
+ * Wheel speed control against the simulator's motor models: the tracking error, the
+ * mismatch of the wheels, how long they take to settle on a new speed and how far the
+ * robot turns off straight, open loop and closed loop.  --tune searches a grid of gains
+ *
+ * usage: speed_bench [--gains KP:KI:KD] [--tune]
+ */
+int main(int argc, char **argv) {
+  int kp = Config::SPEED_KP, ki = Config::SPEED_KI, kd = Config::SPEED_KD;
+  bool tune = false;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--gains" && i + 1 < argc && sscanf(argv[i + 1], "%d:%d:%d", &kp, &ki, &kd) == 3)
+      i++;
+    else if (arg == "--tune")
+      tune = true;
+    else {
+      usage(argv[0]);
+      return arg == "-h" || arg == "--help" ? 0 : 1;
+    }
+  }
+
+  if (tune) {
+    static const int kps[] = { 0, 32, 64, 128, 192, 256, 384 };
+    static const int kis[] = { 16, 32, 64, 96, 128, 192, 256 };
+    static const int kds[] = { 0, 32, 64, 128 };
+    double best = 1e300;
+    for (int p : kps)
+      for (int i : kis)
+        for (int d : kds) {
+          double c = cost(p, i, d);
+          if (c < best) {
+            best = c;
+            kp = p;
+            ki = i;
+            kd = d;
+          }
+        }
+    printf("best gains %d:%d:%d, %.2f cm/s RMS error summed over the models\n\n", kp, ki, kd, best);
+  }
+
+  printf("gains %d:%d:%d, target %u ticks/s at 255, speeds", kp, ki, kd, Config::ENCODER_MAX_RATE);
+  for (int s = 0; s < NUM_SPEEDS; s++)
+    printf(" %d", speeds[s]);
+  printf(" for %d ms each\n\n", SEGMENT);
+  printf("%-22s %-7s %11s %11s %10s %9s\n", "model", "loop", "error cm/s", "L-R cm/s", "settle ms", "drift deg");
+  for (int m = 0; m < NUM_MODELS; m++) {
+    for (int closed = 0; closed < 2; closed++) {
+      Result r = drive(models[m], closed, kp, ki, kd);
+      printf("%-22s %-7s %11.2f %11.2f %10.0f %9.1f\n", closed ? "" : models[m].name, closed ? "closed" : "open",
+             r.error, r.mismatch, r.settle, r.drift);
+    }
+  }
+  return 0;
+}
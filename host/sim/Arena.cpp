@@ -0,0 +1,246 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "Arena.h"
+#include <math.h>
+
+using namespace sim;
+
+#define DEG_TO_RAD (M_PI / 180.0)
+#define MAX_STEP 0.005 //integrate the motion in steps of at most 5ms
+#define CONTACT_MARGIN 2.0 //cm the robot has to get clear before it can collide again
+
+/**
+ * Constructor
+ * An empty room of width x height cm with the robot in the middle facing +x
+ */
+Arena::Arena(double w, double h): radius(10), wheelBase(14), maxSpeed(60), deadband(70),
+                                  rightGain(1), rightDeadband(70), curve(1), lag(0), cellSize(10),
+                                  width(w), height(h), x(w / 2), y(h / 2), heading(0),
+                                  travelled(0), forward(0), forwardTime(0), turningTime(0),
+                                  leftSpeed(0), rightSpeed(0), leftTravel(0), rightTravel(0),
+                                  columns((int)ceil(w / cellSize)), visited(columns * (int)ceil(h / cellSize)),
+                                  inContact(false), collisions(0) {
+  visit();
+}
+
+/**
+ * Add an axis aligned box shaped obstacle
+ */
+void Arena::addBox(double x0, double y0, double x1, double y1) {
+  Box box = { fmin(x0, x1), fmin(y0, y1), fmax(x0, x1), fmax(y0, y1) };
+  boxes.push_back(box);
+}
+
+/**
+ * Put the robot somewhere
+ */
+void Arena::place(double px, double py, double h) {
+  x = px;
+  y = py;
+  heading = h;
+  inContact = false;
+  visit();
+}
+
+/**
+ * Mark the cell the centre of the robot is in
+ */
+void Arena::visit() {
+  int column = (int)(x / cellSize);
+  int row = (int)(y / cellSize);
+  size_t cell = (size_t)(row * columns + column);
+  if (column >= 0 && column < columns && cell < visited.size())
+    visited[cell] = true;
+}
+
+/**
+ * Share of the cells the centre of the robot can get to that it has been in, 0 to 1.
+ * A cell counts as reachable if the robot fits at its centre
+ */
+double Arena::getCoverage() const {
+  size_t reachable = 0, covered = 0;
+  for (size_t cell = 0; cell < visited.size(); cell++) {
+    double cx = (cell % columns + 0.5) * cellSize;
+    double cy = (cell / columns + 0.5) * cellSize;
+    if (visited[cell])
+      covered++;
+    else if (blocked(cx, cy, 0))
+      continue;
+    reachable++;
+  }
+  return reachable ? (double)covered / reachable : 0;
+}
+
+/**
+ * Wheel surface speed in cm/s for a signed PWM value.
+ * The wheels do not turn at all below the deadband and speed up along curve above it
+ */
+double Arena::wheelSpeed(int pwm, int wheelDeadband, double gain) const {
+  int magnitude = pwm < 0 ? -pwm : pwm;
+  if (magnitude <= wheelDeadband)
+    return 0;
+  double speed = gain * maxSpeed * pow((magnitude - wheelDeadband) / (255.0 - wheelDeadband), curve);
+  return pwm < 0 ? -speed : speed;
+}
+
+/**
+ * Differential drive kinematics.  A move that would overlap a wall or an obstacle is
+ * refused, apart from sliding along it, and the wheels slip.  Running into something
+ * counts as one collision until the robot gets clear.
+ * With a lag the wheel speeds approach the ones for the PWM exponentially
+ */
+void Arena::drive(int leftPwm, int rightPwm, double dt) {
+  double targetLeft = wheelSpeed(leftPwm, deadband, 1);
+  double targetRight = wheelSpeed(rightPwm, rightDeadband, rightGain);
+  while (dt > 0) {
+    double step = dt > MAX_STEP ? MAX_STEP : dt;
+    dt -= step;
+    if (lag > 0) {
+      double follow = 1 - exp(-step / lag);
+      leftSpeed += (targetLeft - leftSpeed) * follow;
+      rightSpeed += (targetRight - rightSpeed) * follow;
+    }
+    else {
+      leftSpeed = targetLeft;
+      rightSpeed = targetRight;
+    }
+    leftTravel += fabs(leftSpeed) * step;
+    rightTravel += fabs(rightSpeed) * step;
+    double vl = leftSpeed, vr = rightSpeed;
+    double v = (vl + vr) / 2;
+    double w = (vr - vl) / wheelBase / DEG_TO_RAD;
+    double mid = (heading + w * step / 2) * DEG_TO_RAD;
+    double nx = x + v * step * cos(mid);
+    double ny = y + v * step * sin(mid);
+    heading = fmod(heading + w * step + 360.0, 360.0);
+    if ((vl > 0 && vr < 0) || (vl < 0 && vr > 0))
+      turningTime += step;
+    if (v == 0)
+      continue;
+    bool ahead = v > 0 && vl > 0 && vr > 0;
+    if (ahead)
+      forwardTime += step;
+    if (!blocked(nx, ny, 0)) {
+      travelled += fabs(v) * step;
+      if (ahead)
+        forward += v * step;
+      x = nx;
+      y = ny;
+      visit();
+      //clear once it has properly got away, not while scraping along
+      if (inContact && !blocked(x, y, CONTACT_MARGIN))
+        inContact = false;
+      continue;
+    }
+    if (!inContact)
+      collisions++;
+    inContact = true;
+    //slide along whatever is in the way
+    if (!blocked(nx, y, 0)) {
+      travelled += fabs(nx - x);
+      x = nx;
+    }
+    else if (!blocked(x, ny, 0)) {
+      travelled += fabs(ny - y);
+      y = ny;
+    }
+    visit();
+  }
+}
+
+/**
+ * True if the robot's body, grown by margin, would overlap a wall or an obstacle at (px, py)
+ */
+bool Arena::blocked(double px, double py, double margin) const {
+  double r = radius + margin;
+  if (px - r < 0 || py - r < 0 || px + r > width || py + r > height)
+    return true;
+  for (size_t i = 0; i < boxes.size(); i++) {
+    const Box &b = boxes[i];
+    double cx = fmax(b.x0, fmin(px, b.x1));
+    double cy = fmax(b.y0, fmin(py, b.y1));
+    if ((cx - px) * (cx - px) + (cy - py) * (cy - py) < r * r)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Distance along the unit ray (dx, dy) from (ox, oy) to a box, or a negative value on a miss
+ */
+double Arena::rayToBox(const Box &b, double ox, double oy, double dx, double dy) const {
+  double tmin = -INFINITY;
+  double tmax = INFINITY;
+  if (dx != 0) {
+    double t1 = (b.x0 - ox) / dx, t2 = (b.x1 - ox) / dx;
+    tmin = fmax(tmin, fmin(t1, t2));
+    tmax = fmin(tmax, fmax(t1, t2));
+  }
+  else if (ox < b.x0 || ox > b.x1) {
+    return -1;
+  }
+  if (dy != 0) {
+    double t1 = (b.y0 - oy) / dy, t2 = (b.y1 - oy) / dy;
+    tmin = fmax(tmin, fmin(t1, t2));
+    tmax = fmin(tmax, fmax(t1, t2));
+  }
+  else if (oy < b.y0 || oy > b.y1) {
+    return -1;
+  }
+  if (tmax < 0 || tmin > tmax)
+    return -1;
+  return tmin < 0 ? 0 : tmin;
+}
+
+/**
+ * Ray cast from the front of the robot against the walls and the obstacles
+ */
+double Arena::range(double angle, double maxCm) const {
+  double h = heading * DEG_TO_RAD;
+  double ox = x + radius * cos(h);
+  double oy = y + radius * sin(h);
+  double a = (heading + angle) * DEG_TO_RAD;
+  double dx = cos(a);
+  double dy = sin(a);
+  double best = maxCm;
+  if (dx > 1e-9) best = fmin(best, (width - ox) / dx);
+  if (dx < -1e-9) best = fmin(best, -ox / dx);
+  if (dy > 1e-9) best = fmin(best, (height - oy) / dy);
+  if (dy < -1e-9) best = fmin(best, -oy / dy);
+  for (size_t i = 0; i < boxes.size(); i++) {
+    double t = rayToBox(boxes[i], ox, oy, dx, dy);
+    if (t >= 0 && t < best)
+      best = t;
+  }
+  return best < 0 ? 0 : best;
+}
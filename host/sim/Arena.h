@@ -0,0 +1,120 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <vector>
+
+namespace sim {
+
+  /**
+   * A flat rectangular room with optional box shaped obstacles and one
+   * differential drive robot in it.  Units are cm, seconds and degrees.
+   * (0, 0) is the bottom left corner, heading 0 points along +x.
+   */
+  class Arena {
+    public:
+      Arena(double width, double height);
+
+      void addBox(double x0, double y0, double x1, double y1);
+      void place(double x, double y, double heading);
+
+      /**
+       * Move the robot for dt seconds with the given signed PWM on each wheel
+       */
+      void drive(int leftPwm, int rightPwm, double dt);
+
+      /**
+       * Distance in cm from the sensor at the front of the robot to the first
+       * surface along a ray angle degrees off the heading.  Returns maxCm if
+       * nothing is closer than that.
+       */
+      double range(double angle, double maxCm) const;
+
+      /**
+       * True if the robot fits at (px, py) with margin cm to spare from walls and boxes
+       */
+      bool isFree(double px, double py, double margin) const { return !blocked(px, py, margin); }
+
+      double getX() const { return x; }
+      double getY() const { return y; }
+      double getHeading() const { return heading; }
+      double getDistanceTravelled() const { return travelled; }
+      double getMeanForwardSpeed() const { return forwardTime > 0 ? forward / forwardTime : 0; }
+      double getTurningTime() const { return turningTime; }
+      double getWheelTravel(bool right) const { return right ? rightTravel : leftTravel; }
+      double getWheelSpeed(bool right) const { return right ? rightSpeed : leftSpeed; }
+      double getCoverage() const;
+      unsigned long getCollisions() const { return collisions; }
+
+      // robot model
+      double radius;       // body radius used for collisions
+      double wheelBase;    // distance between the wheels
+      double maxSpeed;     // wheel speed at PWM 255 in cm/s
+      int deadband;        // PWM below which the wheels do not turn
+      double rightGain;    // right wheel speed over the left's at the same PWM above the deadband
+      int rightDeadband;   // deadband of the right wheel
+      double curve;        // speed goes with the PWM above the deadband to this power, 1 is linear
+      double lag;          // s, time constant the wheels take to get to a new speed, 0 for at once
+      double cellSize;     // coverage is counted in square cells of this size
+
+    private:
+      struct Box { double x0, y0, x1, y1; };
+
+      double wheelSpeed(int pwm, int wheelDeadband, double gain) const;
+      bool blocked(double px, double py, double margin) const;
+      double rayToBox(const Box &box, double ox, double oy, double dx, double dy) const;
+      void visit();
+
+      double width;
+      double height;
+      std::vector<Box> boxes;
+      double x;
+      double y;
+      double heading;
+      double travelled;
+      double forward;      // cm made good driving ahead, i.e. not spinning or reversing
+      double forwardTime;  // s spent driving ahead
+      double turningTime;  // s spent with the wheels turning opposite ways
+      double leftSpeed;    // cm/s the wheels' surfaces are moving at
+      double rightSpeed;
+      double leftTravel;   // cm each wheel's surface has turned through, either way
+      double rightTravel;
+      int columns;
+      std::vector<bool> visited;  // cells the centre of the robot has been in
+      bool inContact;
+      unsigned long collisions;
+  };
+}
+
+#endif
@@ -0,0 +1,403 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "Board.h"
+#include "Arena.h"
+#include <cstdio>
+
+using namespace sim;
+
+// motor commands, same values as AFMotor.h
+#define MOTOR_FORWARD 1
+#define MOTOR_BACKWARD 2
+
+// interrupt modes, same values as Arduino.h
+#define INTERRUPT_CHANGE 1
+#define INTERRUPT_FALLING 2
+#define INTERRUPT_RISING 3
+
+// HC-SR04 timing
+#define US_ROUNDTRIP_CM 57
+#define ECHO_START_DELAY 450 //us from the end of the trigger pulse to the rising echo
+#define SENSOR_RANGE 400 //cm, nothing further away is ever seen
+#define SENSOR_MIN_RANGE 2 //cm, anything closer reads as this
+#define NO_ECHO_TIME 38000 //us the echo line stays high when nothing is seen
+
+// avr-libc RANDOM_MAX
+#define RANDOM_MAX 0x7FFFFFFFL
+
+static thread_local Board *currentBoard = 0;
+
+/**
+ * Signed PWM actually driving the wheel.  BRAKE and RELEASE both stop it
+ */
+int MotorPort::output() const {
+  if (command == MOTOR_FORWARD)
+    return pwm;
+  if (command == MOTOR_BACKWARD)
+    return -pwm;
+  return 0;
+}
+
+/**
+ * Bytes still waiting in the transmit buffer of a UART at the given time
+ */
+int SerialPort::txQueued(uint64_t now) const {
+  uint64_t t = byteTime();
+  if (t == 0 || txBusyUntil <= now)
+    return 0;
+  return (int)((txBusyUntil - now + t - 1) / t);
+}
+
+/**
+ * Constructor
+ * All pins start as low inputs, the clock at zero and there is no world attached
+ */
+Board::Board(): nowMicros(0), worldMicros(0), eventSequence(0), randomState(1), analogNoise(512),
+                timerPeriod(0), timerHandler(0), timerRunning(false), timerGeneration(0),
+                eepromWriteCount(0), leftMotor(1), rightMotor(4), arena(0), pingCount(0),
+                sleepCount(0), asleepMicros(0) {
+  for (int i = 0; i < NUM_PINS; i++) {
+    modes[i] = 0;
+    levels[i] = 0;
+  }
+  for (int i = 0; i < NUM_INTERRUPTS; i++) {
+    interruptHandlers[i] = 0;
+    interruptModes[i] = 0;
+  }
+  for (int i = 0; i < EEPROM_SIZE; i++)
+    eeprom[i] = 0xFF;
+}
+
+/**
+ * Destructor
+ */
+Board::~Board() {
+  if (currentBoard == this)
+    currentBoard = 0;
+}
+
+/**
+ * The board the Arduino stand-ins of this thread talk to.
+ * Falls back to a per thread default board so that global firmware objects can be
+ * constructed before main() has set anything up
+ */
+Board &Board::current() {
+  if (currentBoard == 0) {
+    static thread_local Board defaultBoard;
+    return defaultBoard;
+  }
+  return *currentBoard;
+}
+
+/**
+ * Make board the one the Arduino stand-ins of this thread talk to.  Zero restores the default
+ */
+void Board::setCurrent(Board *board) {
+  currentBoard = board;
+}
+
+/**
+ * Advance the virtual clock by us microseconds.
+ * Scheduled events fire in order at their exact time, and the world moves along with the clock
+ */
+void Board::advance(uint64_t us) {
+  uint64_t until = nowMicros + us;
+  while (!events.empty() && events.top().at <= until) {
+    Event event = events.top();
+    events.pop();
+    if (event.at > nowMicros) {
+      moveWorld(event.at);
+      nowMicros = event.at;
+    }
+    event.action();
+  }
+  moveWorld(until);
+  nowMicros = until;
+}
+
+/**
+ * Run event when the virtual clock reaches atMicros.  Events in the past fire on the next advance()
+ */
+void Board::schedule(uint64_t atMicros, const std::function<void()> &event) {
+  Event e;
+  e.at = atMicros;
+  e.sequence = eventSequence++;
+  e.action = event;
+  events.push(e);
+}
+
+/**
+ * Make bytes arrive on a serial port at atMicros
+ */
+void Board::inject(SerialPort &port, uint64_t atMicros, const std::string &bytes) {
+  if (atMicros <= nowMicros) {
+    port.inject(bytes);
+    return;
+  }
+  SerialPort *p = &port;
+  schedule(atMicros, [p, bytes]() { p->inject(bytes); });
+}
+
+/**
+ * sleep_cpu() in idle mode: the clock runs on to the next interrupt, which is the next
+ * scheduled event (an echo edge or bytes arriving), the USB UART finishing a byte, or at
+ * the latest the next timer 0 overflow
+ */
+void Board::sleep() {
+  uint64_t wake = (nowMicros / TIMER0_OVERFLOW + 1) * TIMER0_OVERFLOW;
+  if (!events.empty() && events.top().at < wake)
+    wake = events.top().at > nowMicros ? events.top().at : nowMicros;
+  int queued = usb.txQueued(nowMicros);
+  if (queued > 0 && usb.txBusyUntil - (queued - 1) * usb.byteTime() < wake)
+    wake = usb.txBusyUntil - (queued - 1) * usb.byteTime();
+  sleepCount++;
+  asleepMicros += wake - nowMicros;
+  advance(wake - nowMicros);
+}
+
+/**
+ * Same semantics as avr-libc srandom() behind Arduino's randomSeed()
+ */
+void Board::randomSeed(unsigned long seed) {
+  randomState = (uint32_t)seed;
+}
+
+/**
+ * avr-libc random(): Park-Miller minimal standard generator using Schrage's method,
+ * so a seed produces the same sequence as on the Uno
+ */
+long Board::random() {
+  int32_t x = (int32_t)randomState;
+  if (x == 0)
+    x = 123459876L;
+  int32_t hi = x / 127773L;
+  int32_t lo = x % 127773L;
+  x = 16807L * lo - 2836L * hi;
+  if (x < 0)
+    x += 0x7fffffffL;
+  randomState = (uint32_t)x;
+  return (long)((uint32_t)x % ((uint32_t)RANDOM_MAX + 1));
+}
+
+/**
+ * Set the mode of a pin
+ */
+void Board::pinMode(int pin, int mode) {
+  if (pin >= 0 && pin < NUM_PINS)
+    modes[pin] = mode;
+}
+
+/**
+ * Drive an output pin.  The falling edge of a trigger pulse fires the ultrasonic sensor on that pin
+ */
+void Board::digitalWrite(int pin, int value) {
+  if (pin < 0 || pin >= NUM_PINS)
+    return;
+  int previous = levels[pin];
+  levels[pin] = value ? 1 : 0;
+  if (previous && !levels[pin] && sensors.count(pin))
+    triggerSensor(pin);
+  if (onPinWrite)
+    onPinWrite(pin, levels[pin]);
+}
+
+/**
+ * attachInterrupt() for INT0 (pin 2) and INT1 (pin 3).  A zero handler detaches
+ */
+void Board::attachInterrupt(int number, void (*handler)(), int mode) {
+  if (number < 0 || number >= NUM_INTERRUPTS)
+    return;
+  interruptHandlers[number] = handler;
+  interruptModes[number] = mode;
+}
+
+/**
+ * Timer1 calls handler every periodUs while running.  Any change starts a new period
+ */
+void Board::setTimer(unsigned long periodUs, void (*handler)(), bool running) {
+  timerPeriod = periodUs;
+  timerHandler = handler;
+  timerRunning = running;
+  uint64_t generation = ++timerGeneration;
+  if (running && handler != 0 && periodUs > 0)
+    schedule(nowMicros + periodUs, [this, generation]() { timerTick(generation); });
+}
+
+void Board::timerTick(uint64_t generation) {
+  if (generation != timerGeneration)
+    return;
+  schedule(nowMicros + timerPeriod, [this, generation]() { timerTick(generation); });
+  timerHandler();
+}
+
+/**
+ * Read the level of a pin
+ */
+int Board::digitalRead(int pin) const {
+  if (pin < 0 || pin >= NUM_PINS)
+    return 0;
+  return levels[pin];
+}
+
+/**
+ * Unconnected analog pins read as noise.  The noise is fixed per board so runs stay reproducible
+ */
+int Board::analogRead(int pin) const {
+  return (analogNoise + pin) & 0x3ff;
+}
+
+/**
+ * Drive an input pin from the simulation side.  Runs the interrupt handler attached to the pin, if any
+ */
+void Board::setInput(int pin, int value) {
+  if (pin < 0 || pin >= NUM_PINS)
+    return;
+  int previous = levels[pin];
+  levels[pin] = value ? 1 : 0;
+  if (previous == levels[pin])
+    return;
+  int number = pin == 2 ? 0 : (pin == 3 ? 1 : -1);
+  if (number < 0 || interruptHandlers[number] == 0)
+    return;
+  int mode = interruptModes[number];
+  if (mode == INTERRUPT_CHANGE || (mode == INTERRUPT_RISING && levels[pin]) || (mode == INTERRUPT_FALLING && !levels[pin]))
+    interruptHandlers[number]();
+}
+
+uint8_t Board::eepromRead(int address) const {
+  return address >= 0 && address < EEPROM_SIZE ? eeprom[address] : 0xFF;
+}
+
+void Board::eepromWrite(int address, uint8_t value) {
+  if (address < 0 || address >= EEPROM_SIZE)
+    return;
+  eeprom[address] = value;
+  eepromWriteCount++;
+}
+
+/**
+ * Fill the EEPROM from a file, e.g. one saved by an earlier run.  A missing file leaves it erased
+ */
+bool Board::loadEeprom(const std::string &path) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (f == 0)
+    return false;
+  size_t n = fread(eeprom, 1, EEPROM_SIZE, f);
+  fclose(f);
+  return n == EEPROM_SIZE;
+}
+
+bool Board::saveEeprom(const std::string &path) const {
+  FILE *f = fopen(path.c_str(), "wb");
+  if (f == 0)
+    return false;
+  size_t n = fwrite(eeprom, 1, EEPROM_SIZE, f);
+  return fclose(f) == 0 && n == EEPROM_SIZE;
+}
+
+/**
+ * Mount an ultrasonic sensor on the robot
+ */
+void Board::addSensor(int triggerPin, int echoPin, double angle) {
+  SensorMount mount;
+  mount.echoPin = echoPin;
+  mount.angle = angle;
+  mount.busy = false;
+  sensors[triggerPin] = mount;
+}
+
+/**
+ * Fit a wheel encoder, its output on pin
+ */
+void Board::addEncoder(int pin, bool right, double edgesPerCm) {
+  EncoderMount mount;
+  mount.pin = pin;
+  mount.right = right;
+  mount.edgesPerCm = edgesPerCm;
+  mount.edges = 0;
+  encoders.push_back(mount);
+}
+
+/**
+ * Distance in cm seen by the sensor whose trigger is triggerPin.  Unknown sensors, or
+ * a board without a world, see nothing within maxCm
+ */
+double Board::rangeCm(int triggerPin, double maxCm) const {
+  std::map<int, SensorMount>::const_iterator it = sensors.find(triggerPin);
+  if (arena == 0 || it == sensors.end())
+    return maxCm;
+  return arena->range(it->second.angle, maxCm);
+}
+
+/**
+ * HC-SR04 behaviour on the falling edge of a trigger pulse: after the burst the echo line
+ * goes high for the round trip time of the nearest surface, or for NO_ECHO_TIME if there
+ * is nothing within range.  Triggers are ignored while the echo line is high
+ */
+void Board::triggerSensor(int triggerPin) {
+  SensorMount &mount = sensors[triggerPin];
+  if (mount.busy)
+    return;
+  mount.busy = true;
+  pingCount++;
+  double cm = rangeCm(triggerPin, SENSOR_RANGE);
+  if (cm < SENSOR_MIN_RANGE)
+    cm = SENSOR_MIN_RANGE;
+  uint64_t echoTime = cm >= SENSOR_RANGE ? NO_ECHO_TIME : (uint64_t)(cm * US_ROUNDTRIP_CM);
+  uint64_t rise = nowMicros + ECHO_START_DELAY;
+  int echoPin = mount.echoPin;
+  SensorMount *m = &mount;
+  schedule(rise, [this, echoPin]() { setInput(echoPin, 1); });
+  schedule(rise + echoTime, [this, echoPin, m]() { setInput(echoPin, 0); m->busy = false; });
+}
+
+/**
+ * Let the robot drive with its current motor outputs up to the given time, and the
+ * encoders follow the wheels.  Every edge comes out, even when a step covers several
+ */
+void Board::moveWorld(uint64_t until) {
+  if (until <= worldMicros)
+    return;
+  if (arena != 0) {
+    arena->drive(motors[leftMotor].output(), motors[rightMotor].output(), (until - worldMicros) / 1e6);
+    for (size_t i = 0; i < encoders.size(); i++) {
+      EncoderMount &e = encoders[i];
+      long long edges = (long long)(arena->getWheelTravel(e.right) * e.edgesPerCm);
+      while (e.edges < edges) {
+        e.edges++;
+        setInput(e.pin, (int)(e.edges & 1));
+      }
+    }
+  }
+  worldMicros = until;
+}
@@ -0,0 +1,220 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _BOARD_H_
+#define _BOARD_H_
+
+#include <stdint.h>
+#include <deque>
+#include <functional>
+#include <map>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+  class Arena;
+
+  /**
+   * One serial link of the board as seen from the outside world.
+   * rx holds bytes waiting to be read by the firmware, tx collects everything it wrote.
+   * If onWrite is set, written bytes are handed to it instead of being collected.
+   */
+  struct SerialPort {
+    SerialPort(): baud(0), txBusyUntil(0) {}
+    std::deque<uint8_t> rx;
+    std::vector<uint8_t> tx;
+    std::function<void(uint8_t)> onWrite;
+    unsigned long baud;
+    uint64_t txBusyUntil;  // when the UART will have shifted out everything queued so far
+    void inject(const std::string &bytes) { rx.insert(rx.end(), bytes.begin(), bytes.end()); }
+    void deliver(uint8_t b) { if (onWrite) onWrite(b); else tx.push_back(b); }
+    uint64_t byteTime() const { return baud ? 10000000ULL / baud : 0; }
+    int txQueued(uint64_t now) const;
+  };
+
+  /**
+   * State of one DC motor channel on the (simulated) Adafruit motor shield
+   */
+  struct MotorPort {
+    MotorPort(): pwm(0), command(0), speedWrites(0), latchWrites(0) {}
+    int pwm;
+    int command;  // FORWARD, BACKWARD, BRAKE or RELEASE from AFMotor.h
+    unsigned long speedWrites;
+    unsigned long latchWrites;
+    int output() const;  // signed PWM actually driving the wheel
+  };
+
+  /**
+   * An ultrasonic sensor mounted on the robot, looking angle degrees off the heading
+   */
+  struct SensorMount {
+    int echoPin;
+    double angle;
+    bool busy;  // burst sent, echo line not yet back to low
+  };
+
+  /**
+   * A wheel encoder: its output toggles every 1 / edgesPerCm of travel of the wheel's
+   * surface, whichever way the wheel turns
+   */
+  struct EncoderMount {
+    int pin;
+    bool right;  // on the right wheel, else the left
+    double edgesPerCm;
+    long long edges;  // edges put out so far
+  };
+
+  /**
+   * The simulated Arduino Uno.
+   * Owns a virtual microsecond clock, an avr-libc compatible random number generator,
+   * the pin states, the serial ports and the motor shield.  Nothing here ever looks at
+   * the wall clock, so a run is fully determined by its inputs.
+   *
+   * The Arduino stand-ins in host/arduino talk to Board::current(), which is per thread,
+   * so several boards can be simulated side by side.
+   */
+  class Board {
+    public:
+      static const int NUM_PINS = 20;
+      static const int NUM_MOTORS = 5;  // motor numbers are 1 based
+      static const int NUM_INTERRUPTS = 2;  // INT0 on pin 2, INT1 on pin 3
+      static const int EEPROM_SIZE = 1024;
+      static const int TIMER0_OVERFLOW = 1024;  // us between the timer 0 interrupts that keep millis() going
+
+      Board();
+      ~Board();
+
+      static Board &current();
+      static void setCurrent(Board *board);
+
+      // clock
+      uint64_t now() const { return nowMicros; }
+      unsigned long micros() const { return (unsigned long)nowMicros; }
+      unsigned long millis() const { return (unsigned long)(nowMicros / 1000); }
+      void advance(uint64_t us);
+      void schedule(uint64_t atMicros, const std::function<void()> &event);
+      void inject(SerialPort &port, uint64_t atMicros, const std::string &bytes);
+      void injectBluetooth(uint64_t atMicros, const std::string &bytes) { inject(bluetooth, atMicros, bytes); }
+
+      // idle sleep
+      void sleep();
+      unsigned long sleeps() const { return sleepCount; }
+      uint64_t asleep() const { return asleepMicros; }
+
+      // random numbers
+      void randomSeed(unsigned long seed);
+      long random();
+      void setAnalogNoise(int value) { analogNoise = value; }
+
+      // pins
+      void pinMode(int pin, int mode);
+      void digitalWrite(int pin, int value);
+      int digitalRead(int pin) const;
+      int analogRead(int pin) const;
+      void setInput(int pin, int value);
+      std::function<void(int pin, int value)> onPinWrite;
+      void attachInterrupt(int number, void (*handler)(), int mode);
+
+      // Timer1 as a periodic interrupt, see TimerOne.h
+      void setTimer(unsigned long periodUs, void (*handler)(), bool running);
+      unsigned long getTimerPeriod() const { return timerPeriod; }
+      void (*getTimerHandler() const)() { return timerHandler; }
+      bool isTimerRunning() const { return timerRunning; }
+
+      // EEPROM, out of range addresses read as erased and ignore writes
+      uint8_t eepromRead(int address) const;
+      void eepromWrite(int address, uint8_t value);
+      unsigned long eepromWrites() const { return eepromWriteCount; }
+      bool loadEeprom(const std::string &path);
+      bool saveEeprom(const std::string &path) const;
+
+      // motor shield
+      MotorPort &motor(int number) { return motors[number]; }
+      void setDriveMotors(int left, int right) { leftMotor = left; rightMotor = right; }
+
+      // ultrasonic sensors and the world they look at
+      void attachArena(Arena *world) { arena = world; }
+      Arena *getArena() const { return arena; }
+      void addSensor(int triggerPin, int echoPin, double angle);
+      void addEncoder(int pin, bool right, double edgesPerCm);
+      double rangeCm(int triggerPin, double maxCm) const;
+      unsigned long pings() const { return pingCount; }
+      void countPing() { pingCount++; }
+
+      SerialPort usb;
+      SerialPort bluetooth;
+
+    private:
+      struct Event {
+        uint64_t at;
+        uint64_t sequence;
+        std::function<void()> action;
+        bool operator>(const Event &other) const {
+          return at != other.at ? at > other.at : sequence > other.sequence;
+        }
+      };
+
+      void moveWorld(uint64_t until);
+      void triggerSensor(int triggerPin);
+      void timerTick(uint64_t generation);
+
+      uint64_t nowMicros;
+      uint64_t worldMicros;
+      uint64_t eventSequence;
+      std::priority_queue<Event, std::vector<Event>, std::greater<Event> > events;
+      uint32_t randomState;
+      int analogNoise;
+      uint8_t modes[NUM_PINS];
+      uint8_t levels[NUM_PINS];
+      void (*interruptHandlers[NUM_INTERRUPTS])();
+      int interruptModes[NUM_INTERRUPTS];
+      unsigned long timerPeriod;
+      void (*timerHandler)();
+      bool timerRunning;
+      uint64_t timerGeneration;  // bumped by every setTimer(), so ticks scheduled before it do nothing
+      uint8_t eeprom[EEPROM_SIZE];
+      unsigned long eepromWriteCount;
+      MotorPort motors[NUM_MOTORS];
+      int leftMotor;
+      int rightMotor;
+      std::map<int, SensorMount> sensors;
+      std::vector<EncoderMount> encoders;
+      Arena *arena;
+      unsigned long pingCount;
+      unsigned long sleepCount;
+      uint64_t asleepMicros;
+  };
+}
+
+#endif
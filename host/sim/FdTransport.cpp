@@ -0,0 +1,156 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "FdTransport.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace sim;
+
+/**
+ * Put a terminal into raw 8 bit mode, so the link is transparent
+ */
+static void makeRaw(int fd) {
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+}
+
+/**
+ * Constructor
+ * Both descriptors are switched to non-blocking mode and closed by the destructor
+ */
+FdTransport::FdTransport(int in, int out): readFd(in), writeFd(out), keepOpenFd(-1), head(0), tail(0), dropped(0) {
+  fcntl(readFd, F_SETFL, fcntl(readFd, F_GETFL) | O_NONBLOCK);
+  fcntl(writeFd, F_SETFL, fcntl(writeFd, F_GETFL) | O_NONBLOCK);
+}
+
+/**
+ * Destructor
+ */
+FdTransport::~FdTransport() {
+  close(readFd);
+  if (writeFd != readFd)
+    close(writeFd);
+  if (keepOpenFd >= 0)
+    close(keepOpenFd);
+}
+
+/**
+ * Open a serial device or the slave end of a pty in raw mode.  Returns 0 on failure
+ */
+FdTransport *FdTransport::openDevice(const std::string &path) {
+  int fd = open(path.c_str(), O_RDWR | O_NOCTTY);
+  if (fd < 0)
+    return 0;
+  if (isatty(fd))
+    makeRaw(fd);
+  return new FdTransport(fd, fd);
+}
+
+/**
+ * Create a pty and return a transport on its master end.  Tools connect to slavePath
+ * Returns 0 on failure
+ */
+FdTransport *FdTransport::openPty(std::string &slavePath) {
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    return 0;
+  slavePath = ptsname(master);
+  int slave = open(slavePath.c_str(), O_RDWR | O_NOCTTY);
+  if (slave < 0) {
+    close(master);
+    return 0;
+  }
+  makeRaw(slave);
+  FdTransport *transport = new FdTransport(master, master);
+  transport->keepOpenFd = slave;
+  return transport;
+}
+
+/**
+ * Nothing to set up, the baud rate of a pipe or pty is meaningless
+ */
+void FdTransport::begin(unsigned long) {
+}
+
+/**
+ * Move whatever the descriptor has into the receive buffer
+ */
+void FdTransport::fill() {
+  if (head == tail)
+    head = tail = 0;
+  if (tail == sizeof(buffer))
+    return;
+  ssize_t n = ::read(readFd, buffer + tail, sizeof(buffer) - tail);
+  if (n > 0)
+    tail += n;
+}
+
+int FdTransport::available() {
+  fill();
+  return (int)(tail - head);
+}
+
+int FdTransport::read() {
+  if (head == tail)
+    fill();
+  return head == tail ? -1 : buffer[head++];
+}
+
+int FdTransport::peek() {
+  if (head == tail)
+    fill();
+  return head == tail ? -1 : buffer[head];
+}
+
+int FdTransport::availableForWrite() {
+  return 64;
+}
+
+size_t FdTransport::write(uint8_t b) {
+  return write(&b, 1);
+}
+
+size_t FdTransport::write(const uint8_t *data, size_t size) {
+  ssize_t n = ::write(writeFd, data, size);
+  if (n < 0)
+    n = 0;
+  dropped += size - n;
+  return size;
+}
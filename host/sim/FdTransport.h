@@ -0,0 +1,79 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _FD_TRANSPORT_H_
+#define _FD_TRANSPORT_H_
+
+#include <string>
+#include "Transport.h"
+
+namespace sim {
+
+  /**
+   * rohrah::Transport over POSIX file descriptors: a pipe, a pty or a real serial device.
+   * Never blocks; bytes the other end is not ready for are dropped like on a radio link.
+   * Used on the host to wire the simulated robot to external tools and as the client
+   * side of those tools
+   */
+  class FdTransport : public rohrah::Transport {
+    public:
+      FdTransport(int readFd, int writeFd);
+      ~FdTransport();
+
+      static FdTransport *openDevice(const std::string &path);
+      static FdTransport *openPty(std::string &slavePath);
+
+      void begin(unsigned long baud);
+      int available();
+      int read();
+      int peek();
+      int availableForWrite();
+      size_t write(uint8_t b);
+      size_t write(const uint8_t *buffer, size_t size);
+      using Print::write;
+
+      unsigned long getDropped() const { return dropped; }
+
+    private:
+      void fill();
+
+      int readFd;
+      int writeFd;
+      int keepOpenFd;  // for a pty, the slave end, so the master survives clients coming and going
+      unsigned char buffer[256];
+      size_t head;
+      size_t tail;
+      unsigned long dropped;
+  };
+}
+
+#endif
@@ -0,0 +1,67 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "Layout.h"
+#include "Arena.h"
+#include "Board.h"
+
+using namespace sim;
+
+// pins and motors of the robot, as wired in RobotConfig.h
+#define ECHO_PIN 2
+#define TRIGGER_PIN 15
+#define LEFT_TRIGGER_PIN 9
+#define RIGHT_TRIGGER_PIN 10
+#define SIDE_SENSOR_ANGLE 30
+#define LEFT_MOTOR_NUMBER 1
+#define RIGHT_MOTOR_NUMBER 4
+#define LEFT_ENCODER_PIN 14
+#define RIGHT_ENCODER_PIN 18
+#define ENCODER_EDGES_PER_CM 1.96 //both edges of a 20 slot disk on a 65mm wheel
+
+void sim::furnish(Arena &arena, bool obstacles) {
+  if (obstacles) {
+    arena.addBox(100, 60, 140, 100);
+    arena.addBox(260, 180, 300, 260);
+    arena.addBox(300, 40, 320, 120);
+  }
+  arena.place(60, 150, 0);
+}
+
+void sim::wireRobot(Board &board) {
+  board.setDriveMotors(LEFT_MOTOR_NUMBER, RIGHT_MOTOR_NUMBER);
+  board.addSensor(TRIGGER_PIN, ECHO_PIN, 0);
+  board.addSensor(LEFT_TRIGGER_PIN, ECHO_PIN, SIDE_SENSOR_ANGLE);
+  board.addSensor(RIGHT_TRIGGER_PIN, ECHO_PIN, -SIDE_SENSOR_ANGLE);
+  board.addEncoder(LEFT_ENCODER_PIN, false, ENCODER_EDGES_PER_CM);
+  board.addEncoder(RIGHT_ENCODER_PIN, true, ENCODER_EDGES_PER_CM);
+}
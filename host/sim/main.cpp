@@ -0,0 +1,325 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+
+#include "Board.h"
+#include "Arena.h"
+#include "Layout.h"
+#include "Frame.h"
+#include "FdTransport.h"
+#include "MotionAssembler.h"
+#include "RemoteControlCommand.h"
+
+// the sketch, compiled from rohrahrobot.ino
+void setup();
+void loop();
+
+using namespace sim;
+
+// motors of the robot, as wired in Robot.cpp
+#define LEFT_MOTOR_NUMBER 1
+#define RIGHT_MOTOR_NUMBER 4
+
+static void usage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  -t, --seconds N      virtual seconds to simulate (default 60)\n"
+    "  -l, --loop-us N      virtual time one pass of loop() costs on top of blocking calls (default 100)\n"
+    "  -s, --seed N         reseed random() after the robot has seeded it from the unconnected analog pin\n"
+    "  -b, --bt BYTES       bytes sent over Bluetooth at start up, e.g. A to start auto mode\n"
+    "      --bt-at MS:BYTES bytes sent over Bluetooth at MS milliseconds, may repeat\n"
+    "      --drive-at MS:L:R    FRAME_DRIVE with left and right speeds L and R at MS milliseconds, may repeat\n"
+    "      --script-at MS:FILE  upload the motion script in FILE at MS milliseconds and run it ('S')\n"
+    "      --serial FILE    write everything the sketch prints on Serial to FILE (- for stdout)\n"
+    "      --bt-out FILE    write everything the sketch sends over Bluetooth to FILE (- for stdout)\n"
+    "      --empty          no obstacles, just the walls\n"
+    "      --no-governor    switch the speed governor off at start up, as if 'G' had been sent\n"
+    "      --start X:Y:H    put the robot at X, Y cm facing H degrees instead of the usual start\n"
+    "      --worn           mismatched motors with a curved response, for calibration ('C') to fix\n"
+    "      --motor-lag MS   time constant of the wheels' response to a new PWM (default 0, at once)\n"
+    "      --battery F      the motors get F of the full battery voltage, e.g. 0.8 when it runs down\n"
+    "      --eeprom FILE    load the EEPROM from FILE if it exists and save it back at the end\n"
+    "      --pty            connect the Bluetooth link to a new pty, whose name is printed\n"
+    "      --realtime       run no faster than real time, e.g. for interactive use over --pty\n", name);
+}
+
+static FILE *openOutput(const char *path) {
+  if (strcmp(path, "-") == 0)
+    return stdout;
+  FILE *f = fopen(path, "wb");
+  if (f == 0) {
+    perror(path);
+    exit(1);
+  }
+  return f;
+}
+
+/**
+ * Bytes of a FRAME_DRIVE frame that sets both motor speeds
+ */
+static std::string driveFrame(int left, int right) {
+  unsigned char payload[5];
+  unsigned char frame[5 + FRAME_OVERHEAD];
+  payload[0] = rohrah::RemoteControlCommand::moveCommand;
+  rohrah::writeInt16(payload + 1, left);
+  rohrah::writeInt16(payload + 3, right);
+  unsigned char size = rohrah::encodeFrame(frame, FRAME_DRIVE, payload, sizeof(payload));
+  return std::string((const char *)frame, size);
+}
+
+/**
+ * Run the sketch on the simulated board against a virtual clock and
+ * report how much faster than real time it went
+ */
+int main(int argc, char **argv) {
+  double seconds = 60;
+  unsigned long loopMicros = 100;
+  bool obstacles = true;
+  unsigned long seed = 0;
+  FILE *serialOut = 0;
+  FILE *btOut = 0;
+  bool pty = false;
+  bool realtime = false;
+  bool worn = false;
+  double lag = 0;
+  double battery = 1;
+  double place[3];
+  bool placed = false;
+  const char *eepromPath = 0;
+  Board &board = Board::current();
+#ifdef BT_HARDWARE_UART
+  SerialPort &btPort = board.usb;  //the sketch talks to the module through Serial
+#else
+  SerialPort &btPort = board.bluetooth;
+#endif
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if ((arg == "-t" || arg == "--seconds") && hasValue)
+      seconds = atof(argv[++i]);
+    else if ((arg == "-l" || arg == "--loop-us") && hasValue)
+      loopMicros = strtoul(argv[++i], 0, 10);
+    else if ((arg == "-s" || arg == "--seed") && hasValue)
+      seed = strtoul(argv[++i], 0, 10);
+    else if ((arg == "-b" || arg == "--bt") && hasValue)
+      board.inject(btPort, 0, argv[++i]);
+    else if (arg == "--bt-at" && hasValue) {
+      std::string spec = argv[++i];
+      size_t colon = spec.find(':');
+      if (colon == std::string::npos) {
+        usage(argv[0]);
+        return 1;
+      }
+      board.inject(btPort, strtoull(spec.c_str(), 0, 10) * 1000, spec.substr(colon + 1));
+    }
+    else if (arg == "--drive-at" && hasValue) {
+      unsigned long ms;
+      int left, right;
+      if (sscanf(argv[++i], "%lu:%d:%d", &ms, &left, &right) != 3) {
+        usage(argv[0]);
+        return 1;
+      }
+      board.inject(btPort, (uint64_t)ms * 1000, driveFrame(left, right));
+    }
+    else if (arg == "--script-at" && hasValue) {
+      std::string spec = argv[++i];
+      size_t colon = spec.find(':');
+      if (colon == std::string::npos) {
+        usage(argv[0]);
+        return 1;
+      }
+      std::ifstream file(spec.substr(colon + 1).c_str());
+      std::vector<unsigned char> code;
+      std::string error;
+      if (!file || !tools::assembleScript(file, code, error)) {
+        fprintf(stderr, "%s: %s\n", spec.substr(colon + 1).c_str(), file ? error.c_str() : strerror(errno));
+        return 1;
+      }
+      board.inject(btPort, strtoull(spec.c_str(), 0, 10) * 1000, tools::scriptFrames(code) + "S");
+    }
+    else if (arg == "--serial" && hasValue)
+      serialOut = openOutput(argv[++i]);
+    else if (arg == "--bt-out" && hasValue)
+      btOut = openOutput(argv[++i]);
+    else if (arg == "--empty")
+      obstacles = false;
+    else if (arg == "--no-governor")
+      board.inject(btPort, 0, "G");
+    else if (arg == "--start" && hasValue) {
+      if (sscanf(argv[++i], "%lf:%lf:%lf", &place[0], &place[1], &place[2]) != 3) {
+        usage(argv[0]);
+        return 1;
+      }
+      placed = true;
+    }
+    else if (arg == "--worn")
+      worn = true;
+    else if (arg == "--motor-lag" && hasValue)
+      lag = atof(argv[++i]) / 1000;
+    else if (arg == "--battery" && hasValue)
+      battery = atof(argv[++i]);
+    else if (arg == "--eeprom" && hasValue)
+      eepromPath = argv[++i];
+    else if (arg == "--pty")
+      pty = true;
+    else if (arg == "--realtime")
+      realtime = true;
+    else {
+      usage(argv[0]);
+      return arg == "-h" || arg == "--help" ? 0 : 1;
+    }
+  }
+
+  Arena arena(400, 300);
+  furnish(arena, obstacles);
+  if (placed)
+    arena.place(place[0], place[1], place[2]);
+  if (worn) {
+    arena.rightGain = 0.85;
+    arena.rightDeadband = 95;
+    arena.curve = 0.6;
+  }
+  arena.lag = lag;
+  arena.maxSpeed *= battery;
+  if (eepromPath)
+    board.loadEeprom(eepromPath);
+  board.attachArena(&arena);
+  wireRobot(board);
+  if (seed != 0)
+    board.randomSeed(seed);
+  board.usb.onWrite = [serialOut](uint8_t b) { if (serialOut) fputc(b, serialOut); };
+  board.bluetooth.onWrite = [btOut](uint8_t b) { if (btOut) fputc(b, btOut); };
+#ifdef BT_HARDWARE_UART
+  //Serial is the Bluetooth link, so --bt-out gets what the sketch prints as well
+  board.usb.onWrite = [serialOut, btOut](uint8_t b) {
+    if (serialOut) fputc(b, serialOut);
+    if (btOut) fputc(b, btOut);
+  };
+#endif
+  double startX = arena.getX(), startY = arena.getY(), startHeading = arena.getHeading();
+
+  FdTransport *link = 0;
+  if (pty) {
+    std::string slave;
+    link = FdTransport::openPty(slave);
+    if (link == 0) {
+      perror("pty");
+      return 1;
+    }
+    printf("bluetooth link on %s\n", slave.c_str());
+    fflush(stdout);
+    btPort.onWrite = [link, btOut](uint8_t b) { link->write(b); if (btOut) fputc(b, btOut); };
+  }
+
+  //catch the robot's answers to 'O', with where it really was at the time, relative to the start
+  rohrah::FrameParser poseParser;
+  int poses = 0;
+  double reckoned[3], actual[3];
+  std::function<void(uint8_t)> btWrite = btPort.onWrite;
+  btPort.onWrite = [&](uint8_t b) {
+    btWrite(b);
+    if (!poseParser.parse(b) || poseParser.getType() != FRAME_POSE || poseParser.getLength() < 6)
+      return;
+    const unsigned char *payload = poseParser.getPayload();
+    reckoned[0] = rohrah::readInt16(payload);
+    reckoned[1] = rohrah::readInt16(payload + 2);
+    reckoned[2] = (unsigned)(rohrah::readInt16(payload + 4) & 0xFFFF) * 360.0 / 65536;
+    double h = startHeading * M_PI / 180, dx = arena.getX() - startX, dy = arena.getY() - startY;
+    actual[0] = dx * cos(h) + dy * sin(h);
+    actual[1] = dy * cos(h) - dx * sin(h);
+    actual[2] = fmod(arena.getHeading() - startHeading + 360.0, 360.0);
+    poses++;
+  };
+
+  uint64_t end = board.now() + (uint64_t)(seconds * 1e6);
+  unsigned long long loops = 0;
+  uint64_t nextPoll = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  setup();
+  while (board.now() < end) {
+    loop();
+    board.advance(loopMicros);
+    loops++;
+    if (board.now() < nextPoll)
+      continue;
+    //once per virtual millisecond, look at the outside world
+    nextPoll = board.now() + 1000;
+    while (link && link->available() > 0)
+      btPort.rx.push_back(link->read());
+    if (realtime) {
+      std::chrono::steady_clock::time_point due = start + std::chrono::microseconds(board.now());
+      if (due > std::chrono::steady_clock::now())
+        std::this_thread::sleep_until(due);
+    }
+  }
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double simulated = board.now() / 1e6;
+
+  printf("simulated      %.3f s in %llu loops (%.1f loops/s, mean loop %.1f us)\n",
+         simulated, loops, loops / simulated, board.now() / (double)loops);
+  printf("wall clock     %.3f s, %.0fx real time\n", wall, wall > 0 ? simulated / wall : 0);
+  printf("pings          %lu\n", board.pings());
+  printf("asleep         %.1f%% of the time in %lu sleeps\n", board.asleep() / 1e4 / simulated, board.sleeps());
+  printf("motor writes   left %lu speed / %lu latch, right %lu speed / %lu latch\n",
+         board.motor(LEFT_MOTOR_NUMBER).speedWrites, board.motor(LEFT_MOTOR_NUMBER).latchWrites,
+         board.motor(RIGHT_MOTOR_NUMBER).speedWrites, board.motor(RIGHT_MOTOR_NUMBER).latchWrites);
+  printf("final pose     x %.1f cm, y %.1f cm, heading %.1f deg\n", arena.getX(), arena.getY(), arena.getHeading());
+  printf("travelled      %.1f cm, %lu collisions\n", arena.getDistanceTravelled(), arena.getCollisions());
+  printf("forward speed  %.1f cm/s mean while driving ahead\n", arena.getMeanForwardSpeed());
+  printf("coverage       %.1f%% of the floor, %.1f s spent turning\n", arena.getCoverage() * 100, arena.getTurningTime());
+  if (poses > 0) {
+    printf("odometry       x %.0f cm, y %.0f cm, heading %.1f deg at the last of %d 'O' replies\n",
+           reckoned[0], reckoned[1], reckoned[2], poses);
+    printf("               x %.1f cm, y %.1f cm, heading %.1f deg really, from the start\n", actual[0], actual[1], actual[2]);
+  }
+
+  if (eepromPath && !board.saveEeprom(eepromPath))
+    perror(eepromPath);
+
+  delete link;
+  if (serialOut && serialOut != stdout)
+    fclose(serialOut);
+  if (btOut && btOut != stdout)
+    fclose(btOut);
+  return 0;
+}
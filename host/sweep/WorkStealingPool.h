@@ -0,0 +1,126 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _WORK_STEALING_POOL_H_
+#define _WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sweep {
+
+  /**
+   * Thread pool for a batch of independent jobs.
+   * Every worker thread has its own deque of jobs, filled round robin by add().  A worker
+   * takes jobs from the back of its own deque and, once that is empty, steals from the
+   * front of the others', so workers whose jobs happen to be short help out the ones whose
+   * jobs are long, without any of them contending for a shared queue.  run() returns when
+   * every job has finished.  Jobs must not add jobs.
+   */
+  class WorkStealingPool {
+    public:
+      typedef std::function<void()> Job;
+
+      explicit WorkStealingPool(unsigned threads): next(0), steals(0) {
+        if (threads == 0)
+          threads = 1;
+        for (unsigned i = 0; i < threads; i++)
+          workers.push_back(std::unique_ptr<Worker>(new Worker));
+      }
+
+      void add(const Job &job) {
+        workers[next]->jobs.push_back(job);
+        next = (next + 1) % workers.size();
+      }
+
+      void run() {
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < workers.size(); i++)
+          threads.push_back(std::thread(&WorkStealingPool::work, this, i));
+        work(0);  //the calling thread is worker 0
+        for (size_t i = 0; i < threads.size(); i++)
+          threads[i].join();
+      }
+
+      unsigned getThreads() const { return (unsigned)workers.size(); }
+      unsigned long getSteals() const { return steals; }
+
+    private:
+      struct Worker {
+        std::mutex lock;
+        std::deque<Job> jobs;
+      };
+
+      /**
+       * Next job for worker self: its own newest, or the oldest of another worker
+       */
+      bool take(unsigned self, Job &job) {
+        {
+          Worker &own = *workers[self];
+          std::lock_guard<std::mutex> guard(own.lock);
+          if (!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            return true;
+          }
+        }
+        for (size_t i = 1; i < workers.size(); i++) {
+          Worker &victim = *workers[(self + i) % workers.size()];
+          std::lock_guard<std::mutex> guard(victim.lock);
+          if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            steals++;
+            return true;
+          }
+        }
+        return false;
+      }
+
+      void work(unsigned self) {
+        Job job;
+        while (take(self, job))
+          job();
+      }
+
+      std::vector<std::unique_ptr<Worker> > workers;
+      size_t next;
+      std::atomic<unsigned long> steals;
+  };
+}
+
+#endif
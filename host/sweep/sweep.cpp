@@ -0,0 +1,290 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Arena.h"
+#include "Board.h"
+#include "Layout.h"
+#include "Robot.h"
+#include "Transport.h"
+#include "WorkStealingPool.h"
+
+using namespace sim;
+typedef rohrah::Robot<rohrah::StandardConfig> Robot;
+using rohrah::RobotParameters;
+
+#define BT_RX_PIN 16 //as in rohrahrobot.ino
+#define BT_TX_PIN 17
+#define BT_BAUD 9600
+
+static void usage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "Monte Carlo search over the auto mode parameters.  Every parameter set drives several\n"
+    "robots, each on its own simulated board with its own seed, in the default arena.\n"
+    "  -n, --sets N            parameter sets to try, the first is the robot's defaults and the second\n"
+    "                          the same with the other way of turning, timed or scanning (default 200)\n"
+    "  -r, --runs N            robots per parameter set (default 10)\n"
+    "  -j, --threads N         worker threads (default: one per core)\n"
+    "      --seed N            seed for drawing the parameter sets (default 1)\n"
+    "      --sweep-run-time    draw the auto mode run time too, instead of keeping the default\n"
+    "      --scatter           start every robot at a free spot and heading drawn from its seed,\n"
+    "                          instead of all at the usual start\n"
+    "      --collision-cost X  score points a collision per minute costs (default 2)\n"
+    "      --top N             parameter sets to list (default 10)\n"
+    "      --csv FILE          write every parameter set and its results to FILE\n", name);
+}
+
+/**
+ * What one robot did
+ */
+struct RunResult {
+  double coverage;  // share of the reachable floor, 0 to 1
+  unsigned long collisions;
+  double turning;  // s
+  double running;  // s in auto mode
+};
+
+/**
+ * A parameter set and the mean results of its robots
+ */
+struct Candidate {
+  RobotParameters parameters;
+  double coverage;  // %
+  double collisionRate;  // per minute
+  double turningShare;  // % of the time in auto mode
+  double score;
+};
+
+/**
+ * One robot on a board of its own, from power on to the end of its auto mode run
+ */
+static RunResult simulate(const RobotParameters &parameters, unsigned long seed, bool scatter) {
+  Board board;
+  Board::setCurrent(&board);
+  Arena arena(400, 300);
+  furnish(arena, true);
+  if (scatter) {
+    std::mt19937 rng(seed);
+    double x, y;
+    do {
+      x = std::uniform_real_distribution<double>(0, 400)(rng);
+      y = std::uniform_real_distribution<double>(0, 300)(rng);
+    } while (!arena.isFree(x, y, 10));
+    arena.place(x, y, std::uniform_real_distribution<double>(0, 360)(rng));
+  }
+  board.attachArena(&arena);
+  wireRobot(board);
+  board.usb.onWrite = [](uint8_t) {};
+  board.bluetooth.onWrite = [](uint8_t) {};
+
+  RunResult result;
+  {
+    SoftwareSerial serial(BT_RX_PIN, BT_TX_PIN);
+    rohrah::SoftwareSerialTransport link(serial);
+    Robot robot(&link, parameters);
+    Serial.begin(9600);
+    link.begin(BT_BAUD);
+    robot.begin();
+    board.randomSeed(seed);
+    board.inject(board.bluetooth, 0, "A");
+    uint64_t end = (parameters.runTime + 1) * 1000000ULL;
+    while (board.now() < end) {
+      robot.run();
+      board.advance(100);
+    }
+    result.coverage = arena.getCoverage();
+    result.collisions = arena.getCollisions();
+    result.turning = arena.getTurningTime();
+    result.running = parameters.runTime;
+  }
+  Board::setCurrent(0);
+  return result;
+}
+
+/**
+ * The defaults, but turning the other way: for a random time if they scan, scanning a
+ * quarter turn if they do not
+ */
+static RobotParameters otherTurns() {
+  RobotParameters p = Robot::defaultParameters;
+  p.scanArc = p.scanArc ? 0 : 90;
+  return p;
+}
+
+/**
+ * A random parameter set around the defaults
+ */
+static RobotParameters draw(std::mt19937 &rng, bool sweepRunTime) {
+  RobotParameters p = Robot::defaultParameters;
+  p.minDistance = std::uniform_int_distribution<unsigned>(5, 40)(rng);
+  p.filterWindow = std::uniform_int_distribution<unsigned>(1, rohrah::StandardConfig::FILTER_WINDOW)(rng);
+  p.minTurnTime = std::uniform_int_distribution<unsigned>(100, 1500)(rng);
+  p.maxTurnTime = p.minTurnTime + std::uniform_int_distribution<unsigned>(1, 1500)(rng);
+  //a third of the sets turn for a random time, the others scan
+  p.scanArc = std::uniform_int_distribution<unsigned>(0, 2)(rng) == 0 ? 0 : std::uniform_int_distribution<unsigned>(45, 360)(rng);
+  if (sweepRunTime)
+    p.runTime = std::uniform_int_distribution<unsigned>(10, 60)(rng);
+  return p;
+}
+
+/**
+ * Step thousands of independent Robots, each with its own virtual clock, random number
+ * generator and parameter set, on a work stealing thread pool, and rank the parameter sets
+ * by floor covered, collisions and time spent turning
+ */
+int main(int argc, char **argv) {
+  unsigned sets = 200;
+  unsigned runs = 10;
+  unsigned threads = std::thread::hardware_concurrency();
+  unsigned long seed = 1;
+  bool sweepRunTime = false;
+  bool scatter = false;
+  double collisionCost = 2;
+  unsigned top = 10;
+  const char *csvPath = 0;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if ((arg == "-n" || arg == "--sets") && hasValue)
+      sets = strtoul(argv[++i], 0, 10);
+    else if ((arg == "-r" || arg == "--runs") && hasValue)
+      runs = strtoul(argv[++i], 0, 10);
+    else if ((arg == "-j" || arg == "--threads") && hasValue)
+      threads = strtoul(argv[++i], 0, 10);
+    else if (arg == "--seed" && hasValue)
+      seed = strtoul(argv[++i], 0, 10);
+    else if (arg == "--sweep-run-time")
+      sweepRunTime = true;
+    else if (arg == "--scatter")
+      scatter = true;
+    else if (arg == "--collision-cost" && hasValue)
+      collisionCost = atof(argv[++i]);
+    else if (arg == "--top" && hasValue)
+      top = strtoul(argv[++i], 0, 10);
+    else if (arg == "--csv" && hasValue)
+      csvPath = argv[++i];
+    else {
+      usage(argv[0]);
+      return arg == "-h" || arg == "--help" ? 0 : 1;
+    }
+  }
+  if (sets == 0 || runs == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  std::mt19937 rng(seed);
+  std::vector<Candidate> candidates(sets);
+  for (unsigned i = 0; i < sets; i++)
+    candidates[i].parameters = i == 0 ? Robot::defaultParameters : i == 1 ? otherTurns() : draw(rng, sweepRunTime);
+
+  //every run writes its own slot, so the jobs share nothing
+  std::vector<RunResult> results(sets * runs);
+  sweep::WorkStealingPool pool(threads);
+  for (unsigned i = 0; i < sets; i++) {
+    for (unsigned j = 0; j < runs; j++) {
+      const RobotParameters *parameters = &candidates[i].parameters;
+      RunResult *result = &results[i * runs + j];
+      unsigned long runSeed = j + 1;  //the same seeds for every set, so they meet the same luck
+      pool.add([parameters, result, runSeed, scatter]() { *result = simulate(*parameters, runSeed, scatter); });
+    }
+  }
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  pool.run();
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  double simulated = 0;
+  for (unsigned i = 0; i < sets; i++) {
+    Candidate &c = candidates[i];
+    double coverage = 0, collisions = 0, turning = 0, running = 0;
+    for (unsigned j = 0; j < runs; j++) {
+      const RunResult &r = results[i * runs + j];
+      coverage += r.coverage;
+      collisions += r.collisions;
+      turning += r.turning;
+      running += r.running;
+    }
+    simulated += running + runs;
+    c.coverage = coverage / runs * 100;
+    c.collisionRate = collisions / (running / 60);
+    c.turningShare = turning / running * 100;
+    c.score = c.coverage - collisionCost * c.collisionRate;
+  }
+
+  printf("%u robots (%u parameter sets x %u runs), %.0f simulated s in %.1f s on %u threads, %lu jobs stolen\n",
+         sets * runs, sets, runs, simulated, wall, pool.getThreads(), pool.getSteals());
+  if (csvPath) {
+    FILE *csv = fopen(csvPath, "w");
+    if (csv == 0) {
+      perror(csvPath);
+      return 1;
+    }
+    fprintf(csv, "set,min_distance,filter_window,min_turn_ms,max_turn_ms,scan_arc_deg,run_time_s,coverage_pct,collisions_per_min,turning_pct,score\n");
+    for (unsigned i = 0; i < sets; i++) {
+      const Candidate &c = candidates[i];
+      fprintf(csv, "%u,%u,%u,%u,%u,%u,%u,%.2f,%.3f,%.2f,%.2f\n", i, c.parameters.minDistance, c.parameters.filterWindow,
+              c.parameters.minTurnTime, c.parameters.maxTurnTime, c.parameters.scanArc, c.parameters.runTime,
+              c.coverage, c.collisionRate, c.turningShare, c.score);
+    }
+    fclose(csv);
+  }
+
+  std::vector<unsigned> order(sets);
+  for (unsigned i = 0; i < sets; i++)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&candidates](unsigned a, unsigned b) {
+    return candidates[a].score > candidates[b].score;
+  });
+  printf("rank  set  min_dist window turn_ms    scan run_s  coverage%%  collisions/min  turning%%  score\n");
+  for (unsigned k = 0; k < sets; k++) {
+    unsigned i = order[k];
+    if (k >= top && i > 1)
+      continue;
+    const Candidate &c = candidates[i];
+    printf("%4u %4u %9u %6u %4u-%-5u %4u %5u %10.1f %15.2f %9.1f %6.1f%s\n", k + 1, i, c.parameters.minDistance,
+           c.parameters.filterWindow, c.parameters.minTurnTime, c.parameters.maxTurnTime, c.parameters.scanArc,
+           c.parameters.runTime, c.coverage, c.collisionRate, c.turningShare, c.score,
+           i == 0 ? "  (defaults)" : i == 1 ? "  (defaults, other turns)" : "");
+  }
+  return 0;
+}
@@ -0,0 +1,424 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <sstream>
+
+#include "AvrLayout.h"
+
+using namespace tools;
+
+namespace {
+
+  /**
+   * Each line readelf prints, or false with error if it could not run
+   */
+  bool readelf(const std::string &arguments, std::vector<std::string> &lines, std::string &error) {
+    std::string command = "readelf --wide " + arguments + " 2>/dev/null";
+    FILE *pipe = popen(command.c_str(), "r");
+    if (pipe == 0) {
+      error = "cannot run readelf";
+      return false;
+    }
+    std::string line;
+    char buffer[4096];
+    while (fgets(buffer, sizeof(buffer), pipe)) {
+      line += buffer;
+      if (!line.empty() && line[line.size() - 1] == '\n') {
+        line.erase(line.size() - 1);
+        lines.push_back(line);
+        line.clear();
+      }
+    }
+    if (pclose(pipe) != 0 || lines.empty()) {
+      error = "readelf " + arguments + " failed";
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * AVR width of a base type or a typedef of a fixed width integer by its name, 0 if the
+   * name says nothing about it
+   */
+  long avrWidth(const std::string &qualified) {
+    std::string name = qualified.substr(qualified.rfind(':') == std::string::npos ? 0 : qualified.rfind(':') + 1);
+    static const struct { const char *name; long size; } widths[] = {
+      {"char", 1}, {"signed char", 1}, {"unsigned char", 1}, {"bool", 1},
+      {"short int", 2}, {"short unsigned int", 2}, {"int", 2}, {"unsigned int", 2},
+      {"long int", 4}, {"long unsigned int", 4}, {"long long int", 8}, {"long long unsigned int", 8},
+      {"float", 4}, {"double", 4}, {"long double", 4}, //avr-gcc's doubles are floats
+      {"wchar_t", 2}, {"char16_t", 2}, {"char32_t", 4},
+      {"int8_t", 1}, {"uint8_t", 1}, {"__int8_t", 1}, {"__uint8_t", 1},
+      {"int16_t", 2}, {"uint16_t", 2}, {"__int16_t", 2}, {"__uint16_t", 2},
+      {"int32_t", 4}, {"uint32_t", 4}, {"__int32_t", 4}, {"__uint32_t", 4},
+      {"int64_t", 8}, {"uint64_t", 8}, {"__int64_t", 8}, {"__uint64_t", 8},
+      {"size_t", 2}, {"ssize_t", 2}, {"ptrdiff_t", 2}, {"intptr_t", 2}, {"uintptr_t", 2}
+    };
+    for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++) {
+      if (name == widths[i].name)
+        return widths[i].size;
+    }
+    return 0;
+  }
+
+  /**
+   * The value of an attribute as readelf --wide prints it, without the form and offset
+   * readelf puts in front, e.g. "(strp) (offset: 0x59): " or "(ref4) "
+   */
+  std::string attributeValue(std::string text) {
+    while (!text.empty() && text[0] == '(') {
+      size_t end = text.find(')');
+      if (end == std::string::npos)
+        break;
+      size_t next = text.compare(end, 3, "): ") == 0 ? end + 3 : end + 2;
+      if (text.compare(end, 2, ") ") != 0 && text.compare(end, 3, "): ") != 0)
+        break;
+      text = text.substr(next);
+    }
+    return text;
+  }
+}
+
+/**
+ * Read the debug information and the section headers of the ELF file at path.  Returns
+ * false with what went wrong in error
+ */
+bool AvrLayout::load(const std::string &path, std::string &error) {
+  std::vector<std::string> lines;
+  if (!readelf("--section-headers '" + path + "'", lines, error))
+    return false;
+  for (size_t i = 0; i < lines.size(); i++) {
+    //  [Nr] Name Type Address Off Size ...
+    size_t bracket = lines[i].find("] ");
+    if (bracket == std::string::npos)
+      continue;
+    std::istringstream words(lines[i].substr(bracket + 2));
+    std::string name, type, address, offset, size;
+    if (words >> name >> type >> address >> offset >> size && name.compare(0, 9, ".progmem.") == 0) {
+      unsigned long start = strtoul(address.c_str(), 0, 16);
+      progmem.push_back(std::make_pair(start, start + strtoul(size.c_str(), 0, 16)));
+    }
+  }
+
+  lines.clear();
+  if (!readelf("--debug-dump=info '" + path + "'", lines, error))
+    return false;
+  std::vector<long> stack; //the DIE at each depth
+  long current = -1;
+  for (size_t i = 0; i < lines.size(); i++) {
+    const std::string &line = lines[i];
+    // <depth><offset>: Abbrev Number: n (DW_TAG_tag)
+    if (line.compare(0, 2, " <") == 0 && line.find(">: Abbrev Number:") != std::string::npos) {
+      current = -1;
+      size_t tag = line.find("(DW_TAG_");
+      if (tag == std::string::npos)
+        continue; //the end of a list of children
+      int depth = atoi(line.c_str() + 2);
+      long offset = strtol(line.c_str() + line.find("><") + 2, 0, 16);
+      stack.resize(depth + 1);
+      stack[depth] = offset;
+      Die &die = dies[offset];
+      die.offset = offset;
+      die.tag = line.substr(tag + 8, line.find(')', tag) - tag - 8);
+      die.parent = depth > 0 ? stack[depth - 1] : -1;
+      die.unit = stack[0];
+      if (depth > 0)
+        dies[stack[depth - 1]].children.push_back(offset);
+      current = offset;
+      continue;
+    }
+    //    <offset>   DW_AT_name        : value
+    size_t at = line.find("DW_AT_");
+    if (current < 0 || at == std::string::npos)
+      continue;
+    size_t colon = line.find(": ", at);
+    std::string name = line.substr(at + 6, line.find_first_of(" :", at) - at - 6);
+    dies[current].attributes[name] = attributeValue(colon == std::string::npos ? "" : line.substr(colon + 2));
+  }
+
+  for (std::map<long, Die>::const_iterator i = dies.begin(); i != dies.end(); ++i) {
+    const Die &die = i->second;
+    bool aggregate = die.tag == "structure_type" || die.tag == "class_type" || die.tag == "union_type" ||
+                     die.tag == "enumeration_type";
+    if (aggregate && !die.attributes.count("declaration") && die.attributes.count("name"))
+      definitions.insert(std::make_pair(qualifiedName(i->first), i->first));
+  }
+  return true;
+}
+
+/**
+ * The DIE at offset, 0 if there is none
+ */
+const AvrLayout::Die *AvrLayout::find(long offset) const {
+  std::map<long, Die>::const_iterator i = dies.find(offset);
+  return i == dies.end() ? 0 : &i->second;
+}
+
+/**
+ * The complete type for a declaration of one, which may be in another unit
+ */
+const AvrLayout::Die *AvrLayout::definition(const Die *die) const {
+  if (!die->attributes.count("declaration"))
+    return die;
+  std::map<std::string, long>::const_iterator found = definitions.find(qualifiedName(die->offset));
+  return found == definitions.end() ? 0 : find(found->second);
+}
+
+/**
+ * Name of the DIE at offset with the namespaces, classes and functions it is in, e.g.
+ * rohrah::Robot<rohrah::StandardConfig>
+ */
+std::string AvrLayout::qualifiedName(long offset) const {
+  const Die *die = find(offset);
+  if (die == 0)
+    return "";
+  if (!die->attributes.count("name")) {
+    //the out of line part of a function or a static member, named where it was declared
+    for (const char *link : {"specification", "abstract_origin"}) {
+      if (reference(die, link) >= 0)
+        return qualifiedName(reference(die, link));
+    }
+  }
+  std::map<std::string, std::string>::const_iterator name = die->attributes.find("name");
+  std::string own = name == die->attributes.end() ? (die->tag == "namespace" ? "(anonymous namespace)" : "") : name->second;
+  const Die *parent = find(die->parent);
+  if (parent == 0 || parent->tag == "compile_unit")
+    return own;
+  std::string outer = qualifiedName(die->parent);
+  return outer.empty() ? own : outer + "::" + own;
+}
+
+/**
+ * Offset of the DIE an attribute such as type refers to, -1 if there is none
+ */
+long AvrLayout::reference(const Die *die, const char *attribute) const {
+  std::map<std::string, std::string>::const_iterator value = die->attributes.find(attribute);
+  if (value == die->attributes.end() || value->second.compare(0, 3, "<0x") != 0)
+    return -1;
+  return strtol(value->second.c_str() + 3, 0, 16);
+}
+
+/**
+ * Bytes the type at offset takes on the AVR, 0 for void or what cannot be worked out
+ */
+long AvrLayout::typeSize(long offset) const {
+  std::map<long, long>::const_iterator memo = sizes.find(offset);
+  if (memo != sizes.end())
+    return memo->second;
+  const Die *die = find(offset);
+  long size = 0;
+  if (die == 0) {
+    size = 0;
+  }
+  else if (die->tag == "base_type") {
+    size = avrWidth(die->attributes.count("name") ? die->attributes.find("name")->second : "");
+    if (size == 0 && die->attributes.count("byte_size"))
+      size = atol(die->attributes.find("byte_size")->second.c_str());
+  }
+  else if (die->tag == "pointer_type" || die->tag == "reference_type" || die->tag == "rvalue_reference_type" ||
+           die->tag == "ptr_to_member_type" || die->tag == "unspecified_type") {
+    size = 2;
+  }
+  else if (die->tag == "typedef") {
+    size = avrWidth(qualifiedName(offset));
+    if (size == 0)
+      size = typeSize(reference(die, "type"));
+  }
+  else if (die->tag == "const_type" || die->tag == "volatile_type" || die->tag == "restrict_type" ||
+           die->tag == "atomic_type") {
+    size = typeSize(reference(die, "type"));
+  }
+  else if (die->tag == "enumeration_type") {
+    const Die *complete = definition(die);
+    size = complete && reference(complete, "type") >= 0 ? typeSize(reference(complete, "type")) : 2;
+  }
+  else if (die->tag == "array_type") {
+    long count = 1;
+    for (size_t i = 0; i < die->children.size(); i++) {
+      const Die *range = find(die->children[i]);
+      if (range->attributes.count("count"))
+        count *= atol(range->attributes.find("count")->second.c_str());
+      else if (range->attributes.count("upper_bound"))
+        count *= atol(range->attributes.find("upper_bound")->second.c_str()) + 1;
+      else
+        count = 0; //flexible
+    }
+    size = count * typeSize(reference(die, "type"));
+  }
+  else if (die->tag == "structure_type" || die->tag == "class_type" || die->tag == "union_type") {
+    const Die *complete = definition(die);
+    if (complete)
+      size = std::max(structSize(complete), 1L); //an empty object still takes a byte
+  }
+  sizes[offset] = size;
+  return size;
+}
+
+/**
+ * Bytes the data members and bases of a complete struct, class or union take on the AVR,
+ * 0 if there are none, as for an empty base.  Bit fields next to each other share bytes
+ */
+long AvrLayout::structSize(const Die *die) const {
+  bool isUnion = die->tag == "union_type";
+  long size = 0;
+  long bits = 0;
+  for (size_t i = 0; i < die->children.size(); i++) {
+    const Die *child = find(die->children[i]);
+    long part = 0;
+    if (child->tag == "inheritance") {
+      const Die *base = find(reference(child, "type"));
+      base = base ? definition(base) : 0;
+      part = base ? structSize(base) : 0;
+    }
+    else if (child->tag == "member" && !child->attributes.count("declaration") && !child->attributes.count("external")) {
+      if (child->attributes.count("bit_size") && !isUnion) {
+        bits += atol(child->attributes.find("bit_size")->second.c_str());
+        continue;
+      }
+      part = typeSize(reference(child, "type"));
+    }
+    else {
+      continue;
+    }
+    size = isUnion ? std::max(size, part) : size + (bits + 7) / 8 + part;
+    bits = 0;
+  }
+  return size + (bits + 7) / 8;
+}
+
+/**
+ * True if address is in a .progmem section, where PROGMEM puts data on the AVR and, in
+ * the host build, the stand-in for it
+ */
+bool AvrLayout::inProgmem(unsigned long address) const {
+  for (size_t i = 0; i < progmem.size(); i++) {
+    if (address >= progmem[i].first && address < progmem[i].second)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Bytes the type with this qualified name takes on the AVR, -1 if there is no such type
+ */
+long AvrLayout::sizeOf(const std::string &type) const {
+  std::map<std::string, long>::const_iterator found = definitions.find(type);
+  return found == definitions.end() ? -1 : typeSize(found->second);
+}
+
+/**
+ * The bases and data members of the type with this qualified name, in order, and the
+ * bytes each takes on the AVR.  Bases are named after their type.  Empty if there is no
+ * such type
+ */
+std::vector<AvrLayout::Member> AvrLayout::members(const std::string &type) const {
+  std::vector<Member> list;
+  std::map<std::string, long>::const_iterator found = definitions.find(type);
+  if (found == definitions.end())
+    return list;
+  const Die *die = find(found->second);
+  for (size_t i = 0; i < die->children.size(); i++) {
+    const Die *child = find(die->children[i]);
+    Member member;
+    if (child->tag == "inheritance") {
+      const Die *base = find(reference(child, "type"));
+      base = base ? definition(base) : 0;
+      member.name = qualifiedName(reference(child, "type"));
+      member.size = base ? structSize(base) : 0;
+    }
+    else if (child->tag == "member" && !child->attributes.count("declaration") && !child->attributes.count("external")) {
+      member.name = child->attributes.count("name") ? child->attributes.find("name")->second : "";
+      member.size = typeSize(reference(child, "type"));
+    }
+    else {
+      continue;
+    }
+    list.push_back(member);
+  }
+  return list;
+}
+
+/**
+ * The variables with static storage, thread local ones included (they stand for one
+ * board's statics in the host build), defined in units whose source path contains
+ * unitPart, and the bytes of SRAM each takes on the AVR.  Anything in PROGMEM is left
+ * out.  A variable defined in several units, e.g. a static member of a template, is
+ * counted once
+ */
+std::vector<AvrLayout::Static> AvrLayout::statics(const std::string &unitPart) const {
+  std::vector<Static> list;
+  std::set<std::string> seen;
+  for (std::map<long, Die>::const_iterator i = dies.begin(); i != dies.end(); ++i) {
+    const Die &die = i->second;
+    if (die.tag != "variable" || !die.attributes.count("location"))
+      continue;
+    const std::string &location = die.attributes.find("location")->second;
+    size_t address = location.find("DW_OP_addr: ");
+    if (address == std::string::npos && location.find("tls_address") == std::string::npos)
+      continue;
+    if (address != std::string::npos && inProgmem(strtoul(location.c_str() + address + 12, 0, 16)))
+      continue;
+    const Die *unit = find(die.unit);
+    std::string unitName = unit && unit->attributes.count("name") ? unit->attributes.find("name")->second : "";
+    if (unitName.find(unitPart) == std::string::npos)
+      continue;
+
+    //the declaration, for a static member or a variable declared extern before
+    long declared = i->first;
+    const Die *declaration = &die;
+    for (const char *link : {"specification", "abstract_origin"}) {
+      if (reference(declaration, link) >= 0) {
+        declared = reference(declaration, link);
+        declaration = find(declared);
+        break;
+      }
+    }
+    if (declaration == 0)
+      continue;
+    Static variable;
+    variable.name = qualifiedName(declared);
+    std::string key = declaration->attributes.count("linkage_name") ? declaration->attributes.find("linkage_name")->second : variable.name;
+    if (!seen.insert(key).second)
+      continue;
+    variable.unit = unitName;
+    long type = reference(&die, "type") >= 0 ? reference(&die, "type") : reference(declaration, "type");
+    variable.size = typeSize(type);
+    list.push_back(variable);
+  }
+  return list;
+}
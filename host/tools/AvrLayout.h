@@ -0,0 +1,99 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _AVR_LAYOUT_H_
+#define _AVR_LAYOUT_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace tools {
+
+  /**
+   * Sizes of the firmware's types and static variables as avr-gcc lays them out, worked out
+   * from the debug information the host compiler wrote for them.  The host's ints, longs,
+   * doubles and pointers are wider than the AVR's, and it pads for alignment, so sizeof on
+   * the host says little about an Uno.  Here every base type, typedef of a fixed width
+   * integer and pointer counts with its AVR width, and nothing is padded, the AVR aligns
+   * everything to a byte.  Enums count as the type under them, an int unless declared
+   * otherwise.
+   *
+   * The ELF file must have been built with -g.  It is read through binutils' readelf.
+   * What this does not see: string literals that are not in F() and vtables, which avr-gcc
+   * puts in SRAM as well, and the Arduino core's own variables, whose host stand-ins differ
+   */
+  class AvrLayout {
+    public:
+      struct Member {
+        std::string name;
+        long size; //bytes on the AVR
+      };
+
+      struct Static {
+        std::string name;
+        std::string unit; //source file the variable is defined in
+        long size; //bytes on the AVR
+      };
+
+      bool load(const std::string &path, std::string &error);
+      long sizeOf(const std::string &type) const;
+      std::vector<Member> members(const std::string &type) const;
+      std::vector<Static> statics(const std::string &unitPart) const;
+
+    private:
+      struct Die {
+        long offset; //in .debug_info
+        std::string tag; //without DW_TAG_
+        std::map<std::string, std::string> attributes; //without DW_AT_, value as readelf prints it
+        long parent; //offset, -1 for a unit
+        long unit; //offset of the compile unit
+        std::vector<long> children;
+      };
+
+      const Die *find(long offset) const;
+      const Die *definition(const Die *die) const;
+      std::string qualifiedName(long offset) const;
+      long typeSize(long offset) const;
+      long structSize(const Die *die) const;
+      long reference(const Die *die, const char *attribute) const;
+      bool inProgmem(unsigned long address) const;
+
+      std::map<long, Die> dies;
+      std::map<std::string, long> definitions; //qualified name of a complete type to its DIE
+      std::vector<std::pair<unsigned long, unsigned long> > progmem; //address ranges of .progmem sections
+      mutable std::map<long, long> sizes; //memo of typeSize()
+  };
+}
+
+#endif
@@ -0,0 +1,232 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+#include "MotionAssembler.h"
+#include "MotionScript.h"
+#include "Frame.h"
+
+using rohrah::MotionScript;
+
+namespace {
+
+  void put16(std::vector<unsigned char> &code, long value) {
+    unsigned char bytes[2];
+    rohrah::writeInt16(bytes, (int)value);
+    code.push_back(bytes[0]);
+    code.push_back(bytes[1]);
+  }
+
+  /**
+   * Read a number from words into value, within low and high.  A missing one is
+   * fallback, or an error if there is none
+   */
+  bool number(std::istringstream &words, long low, long high, long &value, const char *what,
+              std::string &error, bool optional = false, long fallback = 0) {
+    std::string word;
+    if (!(words >> word)) {
+      if (optional) {
+        value = fallback;
+        return true;
+      }
+      error = std::string("missing ") + what;
+      return false;
+    }
+    char *end;
+    value = strtol(word.c_str(), &end, 10);
+    if (*end != 0 || value < low || value > high) {
+      error = std::string("bad ") + what + " '" + word + "', " + std::to_string(low) + " to " + std::to_string(high);
+      return false;
+    }
+    return true;
+  }
+}
+
+bool tools::assembleScript(std::istream &in, std::vector<unsigned char> &code, std::string &error) {
+  code.clear();
+  std::string line;
+  int lineNumber = 0;
+  std::vector<int> loops; //lines of the open repeats
+  bool ended = false;
+  while (std::getline(in, line)) {
+    lineNumber++;
+    size_t hash = line.find('#');
+    if (hash != std::string::npos)
+      line.erase(hash);
+    std::istringstream words(line);
+    std::string op;
+    if (!(words >> op))
+      continue;
+    std::string problem;
+    long a, b, c;
+    if (ended) {
+      problem = "after end";
+    }
+    else if (op == "drive") {
+      if (number(words, -255, 255, a, "left speed", problem) && number(words, -255, 255, b, "right speed", problem) &&
+          number(words, 0, 65535, c, "time", problem)) {
+        code.push_back(MotionScript::opDrive);
+        put16(code, a);
+        put16(code, b);
+        put16(code, c);
+      }
+    }
+    else if (op == "stop") {
+      if (number(words, 0, 65535, c, "time", problem)) {
+        code.push_back(MotionScript::opDrive);
+        put16(code, 0);
+        put16(code, 0);
+        put16(code, c);
+      }
+    }
+    else if (op == "repeat") {
+      if (number(words, 1, 255, a, "count", problem, true, 0)) {
+        if (loops.size() == MotionScript::MAX_DEPTH) {
+          problem = "loops nest " + std::to_string(MotionScript::MAX_DEPTH) + " deep at most";
+        }
+        else {
+          loops.push_back(lineNumber);
+          code.push_back(MotionScript::opRepeat);
+          code.push_back((unsigned char)a);
+        }
+      }
+    }
+    else if (op == "next") {
+      if (loops.empty()) {
+        problem = "next without repeat";
+      }
+      else {
+        loops.pop_back();
+        code.push_back(MotionScript::opNext);
+      }
+    }
+    else if (op == "until") {
+      std::string which;
+      words >> which;
+      if (which != "closer" && which != "farther") {
+        problem = "until closer or until farther";
+      }
+      else if (number(words, 0, 65535, a, "distance", problem) && number(words, 0, 65535, b, "timeout", problem, true, 65535)) {
+        code.push_back(which == "closer" ? MotionScript::opUntilCloser : MotionScript::opUntilFarther);
+        put16(code, a);
+        put16(code, b);
+      }
+    }
+    else if (op == "end") {
+      if (!loops.empty())
+        problem = "end inside the repeat on line " + std::to_string(loops.back());
+      code.push_back(MotionScript::opEnd);
+      ended = true;
+    }
+    else {
+      problem = "unknown instruction '" + op + "'";
+    }
+    std::string rest;
+    if (problem.empty() && words >> rest)
+      problem = "extra '" + rest + "'";
+    if (!problem.empty()) {
+      error = "line " + std::to_string(lineNumber) + ": " + problem;
+      return false;
+    }
+  }
+  if (!loops.empty()) {
+    error = "line " + std::to_string(loops.back()) + ": repeat without next";
+    return false;
+  }
+  if (!ended)
+    code.push_back(MotionScript::opEnd);
+  if (code.size() > 255) {
+    error = "script is " + std::to_string(code.size()) + " bytes, 255 at most";
+    return false;
+  }
+  return true;
+}
+
+std::string tools::scriptFrames(const std::vector<unsigned char> &code) {
+  std::string frames;
+  size_t offset = 0;
+  do {
+    unsigned char payload[FRAME_MAX_PAYLOAD];
+    unsigned char frame[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD];
+    size_t chunk = std::min(code.size() - offset, (size_t)FRAME_MAX_PAYLOAD - 1);
+    payload[0] = (unsigned char)offset;
+    std::copy(code.begin() + offset, code.begin() + offset + chunk, payload + 1);
+    unsigned char size = rohrah::encodeFrame(frame, FRAME_SCRIPT, payload, chunk + 1);
+    frames.append((const char *)frame, size);
+    offset += chunk;
+  } while (offset < code.size());
+  return frames;
+}
+
+std::string tools::disassembleScript(const std::vector<unsigned char> &code) {
+  std::ostringstream out;
+  std::string indent;
+  for (size_t at = 0; at < code.size(); ) {
+    const unsigned char *p = &code[at];
+    unsigned char size = MotionScript::size(*p);
+    if (size == 0 || at + size > code.size()) {
+      out << "# bad byte " << (int)*p << " at " << at << "\n";
+      break;
+    }
+    if (*p == MotionScript::opNext && indent.size() >= 2)
+      indent.resize(indent.size() - 2);
+    out << indent;
+    switch (*p) {
+      case MotionScript::opEnd:
+        out << "end";
+        break;
+      case MotionScript::opDrive:
+        out << "drive " << rohrah::readInt16(p + 1) << " " << rohrah::readInt16(p + 3) << " " << rohrah::readUint16(p + 5);
+        break;
+      case MotionScript::opRepeat:
+        out << "repeat";
+        if (p[1])
+          out << " " << (int)p[1];
+        indent += "  ";
+        break;
+      case MotionScript::opNext:
+        out << "next";
+        break;
+      default:
+        out << "until " << (*p == MotionScript::opUntilCloser ? "closer " : "farther ") << rohrah::readUint16(p + 1)
+            << " " << rohrah::readUint16(p + 3);
+        break;
+    }
+    out << "\n";
+    at += size;
+  }
+  return out.str();
+}
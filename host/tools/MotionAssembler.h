@@ -0,0 +1,69 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _MOTION_ASSEMBLER_H_
+#define _MOTION_ASSEMBLER_H_
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace tools {
+
+  /**
+   * Assembler for the robot's motion scripts (see MotionScript.h).  One instruction per
+   * line, anything after # is a comment:
+   *   drive LEFT RIGHT MS        speeds -255 to 255, kept for MS ms
+   *   stop MS                    drive 0 0 MS
+   *   repeat [COUNT]             up to the matching next, COUNT times or for ever
+   *   next
+   *   until closer CM [MS]       keep going until the centre sensor has something within
+   *                              CM, for MS at most (default 65535)
+   *   until farther CM [MS]      the same, until it has nothing within CM
+   *   end                        added at the end if the script does not have it
+   * Returns false with the line and what is wrong with it in error
+   */
+  bool assembleScript(std::istream &in, std::vector<unsigned char> &code, std::string &error);
+
+  /**
+   * The FRAME_SCRIPT frames that upload code, in order
+   */
+  std::string scriptFrames(const std::vector<unsigned char> &code);
+
+  /**
+   * The script as text assembleScript() reads, one instruction per line
+   */
+  std::string disassembleScript(const std::vector<unsigned char> &code);
+}
+
+#endif
@@ -0,0 +1,83 @@
+# Flash and SRAM of the firmware, translation unit by translation unit, and of the real
+# sketch when it can be built for the Uno.  Run by the budget target after footprint:
+#
+#   cmake --build build --target budget
+#
+# SIZE is the binutils size of the host toolchain, OBJECTS the object files the firmware
+# was built from (anything outside the sketch folder, e.g. the simulator, is left out).
+# Flash is text + data, SRAM data + bss, what avr-size reports as Program and Data.  These
+# are x86-64 objects, to compare from one change to the next, and are not checked.
+#
+# With ARDUINO_CLI set the sketch in SKETCH is built for the Uno, and this fails if it
+# takes more than FLASH_BUDGET bytes of flash, or leaves less than STACK_RESERVE of the
+# SRAM_BUDGET bytes of SRAM for the stack.
+
+list(FILTER OBJECTS INCLUDE REGEX "/rohrahrobot/")
+execute_process(COMMAND ${SIZE} ${OBJECTS} OUTPUT_VARIABLE table RESULT_VARIABLE failed)
+if(failed)
+  message(FATAL_ERROR "${SIZE} failed")
+endif()
+
+function(pad text width out)
+  string(LENGTH "${text}" length)
+  while(length LESS width)
+    string(PREPEND text " ")
+    math(EXPR length "${length} + 1")
+  endwhile()
+  set(${out} "${text}" PARENT_SCOPE)
+endfunction()
+
+function(row name flash sram)
+  pad("${flash}" 8 flash)
+  pad("${sram}" 8 sram)
+  string(LENGTH "${name}" length)
+  while(length LESS 24)
+    string(APPEND name " ")
+    math(EXPR length "${length} + 1")
+  endwhile()
+  message("${name}${flash}${sram}")
+endfunction()
+
+row("host objects" "flash" "sram")
+set(totalFlash 0)
+set(totalSram 0)
+string(REPLACE "\n" ";" lines "${table}")
+foreach(line IN LISTS lines)
+  # Berkeley format: text data bss dec hex filename
+  if(line MATCHES "^ *([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)[ \t]+[0-9]+[ \t]+[0-9a-fA-F]+[ \t]+(.*)$")
+    math(EXPR flash "${CMAKE_MATCH_1} + ${CMAKE_MATCH_2}")
+    math(EXPR sram "${CMAKE_MATCH_2} + ${CMAKE_MATCH_3}")
+    get_filename_component(name "${CMAKE_MATCH_4}" NAME)
+    string(REGEX REPLACE "\\.(o|obj)$" "" name "${name}")
+    row("${name}" ${flash} ${sram})
+    math(EXPR totalFlash "${totalFlash} + ${flash}")
+    math(EXPR totalSram "${totalSram} + ${sram}")
+  endif()
+endforeach()
+row("total" ${totalFlash} ${totalSram})
+
+if(NOT ARDUINO_CLI)
+  message("arduino-cli not found: flash not checked, SRAM as footprint estimates it")
+  return()
+endif()
+execute_process(COMMAND ${ARDUINO_CLI} compile --fqbn arduino:avr:uno ${SKETCH}
+                OUTPUT_VARIABLE output ERROR_VARIABLE output RESULT_VARIABLE failed)
+if(failed)
+  message(FATAL_ERROR "${ARDUINO_CLI} could not build ${SKETCH} for the Uno:\n${output}")
+endif()
+if(NOT output MATCHES "Sketch uses ([0-9]+) bytes")
+  message(FATAL_ERROR "no size in the output of ${ARDUINO_CLI}:\n${output}")
+endif()
+set(flash ${CMAKE_MATCH_1})
+if(NOT output MATCHES "Global variables use ([0-9]+) bytes")
+  message(FATAL_ERROR "no size in the output of ${ARDUINO_CLI}:\n${output}")
+endif()
+set(sram ${CMAKE_MATCH_1})
+math(EXPR sramLimit "${SRAM_BUDGET} - ${STACK_RESERVE}")
+message("")
+row("Uno" "flash" "sram")
+row("sketch" ${flash} ${sram})
+row("budget" ${FLASH_BUDGET} ${sramLimit})
+if(flash GREATER FLASH_BUDGET OR sram GREATER sramLimit)
+  message(FATAL_ERROR "over budget: flash ${flash} of ${FLASH_BUDGET}, SRAM ${sram} of ${SRAM_BUDGET} bytes with ${STACK_RESERVE} for the stack")
+endif()
@@ -0,0 +1,215 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "AvrLayout.h"
+#include "Robot.h"
+
+using namespace rohrah;
+
+//the configurations measured, instantiated whole so that their layout is in the debug information
+template class rohrah::Robot<StandardConfig>;
+template class rohrah::Robot<LeanConfig>;
+template class rohrah::Robot<BasicConfig>;
+template class rohrah::Robot<MedianConfig>;
+template class rohrah::Robot<ExponentialConfig>;
+//and the profiler, which the board build leaves out of the robot
+static Profiler profiler;
+
+static const char *const configs[] = {"Standard", "Lean", "Basic", "Median", "Exponential"};
+static const int NUM_CONFIGS = sizeof(configs) / sizeof(configs[0]);
+
+/**
+ * Which of the robot's members make up each row of the table
+ */
+static const struct {
+  const char *row;
+  const char *member;
+} components[] = {
+  {"motors", "leftMotor"}, {"motors", "rightMotor"}, {"range finders", "rangeFinders"},
+  {"sensor array", "sensors"}, {"governor", "governor"}, {"odometry", "odometry"}, {"map", "obstacles"},
+  {"turn scanner", "scanner"}, {"calibration", "calibration"}, {"remote control", "remoteControl"},
+  {"telemetry", "telemetry"}, {"speed control", "speedControl"}, {"motion script", "script"},
+  {"link monitor", "linkWatch"}
+};
+static const int NUM_COMPONENTS = sizeof(components) / sizeof(components[0]);
+
+static void usage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [options] [SKETCH]\n"
+    "Print the SRAM each component of the robot takes on the Uno, in every configuration,\n"
+    "and with SKETCH, an ELF of the sketch built with -g, the SRAM of its static variables\n"
+    "translation unit by translation unit.  Fails if those, the core and the stack do not fit.\n"
+    "  --sram N     SRAM of the board (default 2048)\n"
+    "  --core N     SRAM the Arduino core and libraries take (default 340)\n"
+    "  --stack N    SRAM kept for the stack (default 192)\n", name);
+}
+
+static void pad(const char *name, int width) {
+  printf("%-*s", width, name);
+}
+
+/**
+ * The robot's SRAM component by component, one column per configuration.  The next to
+ * last row is whatever the components do not account for (scheduler, state), the last
+ * one the whole robot
+ */
+static bool printComponents(const tools::AvrLayout &layout) {
+  std::vector<std::string> rows;
+  std::map<std::string, long> sizes[NUM_CONFIGS];
+  for (int i = 0; i < NUM_COMPONENTS; i++) {
+    if (rows.empty() || rows.back() != components[i].row)
+      rows.push_back(components[i].row);
+  }
+  for (int c = 0; c < NUM_CONFIGS; c++) {
+    std::string robot = std::string("rohrah::Robot<rohrah::") + configs[c] + "Config>";
+    long total = layout.sizeOf(robot);
+    if (total < 0) {
+      fprintf(stderr, "no debug information for %s\n", robot.c_str());
+      return false;
+    }
+    long parts = 0;
+    std::vector<tools::AvrLayout::Member> members = layout.members(robot);
+    for (size_t m = 0; m < members.size(); m++) {
+      for (int i = 0; i < NUM_COMPONENTS; i++) {
+        if (members[m].name == components[i].member) {
+          sizes[c][components[i].row] += members[m].size;
+          parts += members[m].size;
+        }
+      }
+    }
+    sizes[c]["other"] = total - parts;
+    sizes[c]["robot"] = total;
+  }
+  rows.push_back("other");
+  rows.push_back("robot");
+
+  pad("AVR bytes", 16);
+  for (int c = 0; c < NUM_CONFIGS; c++)
+    printf(" %11s", configs[c]);
+  printf("\n");
+  for (size_t r = 0; r < rows.size(); r++) {
+    pad(rows[r].c_str(), 16);
+    for (int c = 0; c < NUM_CONFIGS; c++)
+      printf(" %11ld", sizes[c][rows[r]]);
+    printf("\n");
+  }
+  printf("%-16s %8ld  more with PROFILING defined\n\n", "profiler", layout.sizeOf("rohrah::Profiler"));
+  return true;
+}
+
+/**
+ * The static SRAM of the sketch, translation unit by translation unit, against what the
+ * board has left after the core and the stack.  False if it does not fit
+ */
+static bool printStatics(const tools::AvrLayout &layout, long sram, long core, long stack) {
+  std::map<std::string, long> units;
+  std::vector<tools::AvrLayout::Static> statics = layout.statics("/rohrahrobot/");
+  long total = 0;
+  for (size_t i = 0; i < statics.size(); i++) {
+    std::string unit = statics[i].unit.substr(statics[i].unit.rfind('/') + 1);
+    units[unit] += statics[i].size;
+    total += statics[i].size;
+  }
+  printf("%-24s %8s\n", "translation unit", "sram");
+  for (std::map<std::string, long>::const_iterator i = units.begin(); i != units.end(); ++i)
+    printf("%-24s %8ld\n", i->first.c_str(), i->second);
+  printf("%-24s %8ld\n", "sketch", total);
+  printf("%-24s %8ld\n", "Arduino core", core);
+  printf("%-24s %8ld\n", "stack reserve", stack);
+  printf("%-24s %8ld\n", "total", total + core + stack);
+  printf("%-24s %8ld\n", "budget", sram);
+  if (total + core + stack > sram) {
+    fprintf(stderr, "over budget: the sketch's %ld bytes of statics leave %ld of %ld bytes of SRAM for the stack\n",
+            total, sram - core - total, sram);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Static SRAM footprint of the firmware as avr-gcc lays it out, worked out from the debug
+ * information of the host build (see AvrLayout.h).  The components come from this
+ * program's own, which instantiates every configuration, the statics from the sketch's.
+ * Either is an estimate: the host stand-ins for the Arduino libraries are not the real
+ * ones, and what the core takes is a fixed figure.  The budget target runs it on the
+ * sketch as the board builds it.
+ *
+ * usage: footprint [--sram N] [--core N] [--stack N] [SKETCH]
+ */
+int main(int argc, char **argv) {
+  long sram = 2048, core = 340, stack = 192;
+  const char *sketch = 0;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--sram" && i + 1 < argc)
+      sram = atol(argv[++i]);
+    else if (arg == "--core" && i + 1 < argc)
+      core = atol(argv[++i]);
+    else if (arg == "--stack" && i + 1 < argc)
+      stack = atol(argv[++i]);
+    else if (arg[0] != '-' && sketch == 0)
+      sketch = argv[i];
+    else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  char path[4096];
+  ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+  path[length > 0 ? length : 0] = 0;
+  tools::AvrLayout self;
+  std::string error;
+  if (!self.load(path, error)) {
+    fprintf(stderr, "footprint: %s\n", error.c_str());
+    return 1;
+  }
+  if (!printComponents(self))
+    return 1;
+  if (sketch == 0)
+    return 0;
+
+  tools::AvrLayout layout;
+  if (!layout.load(sketch, error)) {
+    fprintf(stderr, "%s: %s\n", sketch, error.c_str());
+    return 1;
+  }
+  return printStatics(layout, sram, core, stack) ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+# Trace and telemetry on the Bluetooth link together.  Run by the linkcheck target:
+#
+#   cmake --build build --target linkcheck
+#
+# SIM is the sketch built with TRACING, which runs in auto mode with telemetry on and
+# writes what it sends to CAPTURE.  TRACEREPLAY has to replay the whole trace in it, with
+# no gap in the sequence, and TELEMETRY2CSV has to decode every frame.  Either fails if
+# frames of the two get mixed on the link.
+
+execute_process(COMMAND ${SIM} --bt AT --seconds 20 --bt-out ${CAPTURE}
+                OUTPUT_QUIET RESULT_VARIABLE failed)
+if(failed)
+  message(FATAL_ERROR "${SIM} failed")
+endif()
+
+execute_process(COMMAND ${TRACEREPLAY} ${CAPTURE} OUTPUT_VARIABLE replay RESULT_VARIABLE failed)
+message("${replay}")
+if(failed)
+  message(FATAL_ERROR "the replay of the trace diverged")
+endif()
+if(NOT replay MATCHES "identical" OR replay MATCHES "ends at a gap")
+  message(FATAL_ERROR "the trace did not come through whole")
+endif()
+
+execute_process(COMMAND ${TELEMETRY2CSV} ${CAPTURE} OUTPUT_QUIET ERROR_VARIABLE summary RESULT_VARIABLE failed)
+message("${summary}")
+if(failed OR NOT summary MATCHES "[1-9][0-9]* samples")
+  message(FATAL_ERROR "no telemetry came through")
+endif()
+if(NOT summary MATCHES " 0 lost" OR NOT summary MATCHES " 0 frame errors")
+  message(FATAL_ERROR "telemetry frames were lost or broken")
+endif()
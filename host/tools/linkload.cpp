@@ -0,0 +1,120 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "FdTransport.h"
+#include "Frame.h"
+#include "RemoteControlCommand.h"
+
+using namespace std::chrono;
+
+static void usage(const char *name) {
+  fprintf(stderr,
+    "usage: %s DEVICE [options]\n"
+    "Drive the robot's Bluetooth link with FRAME_DRIVE frames at a fixed rate, then ask\n"
+    "for its loop profile ('P') and print whatever comes back.\n"
+    "  -r, --rate N      frames per second (default 50)\n"
+    "  -t, --seconds N   how long to keep sending (default 5)\n", name);
+}
+
+/**
+ * Load generator for the remote control link.  DEVICE is a serial port, or the pty
+ * printed by rohrahsim --pty --realtime
+ */
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    usage(argv[0]);
+    return 1;
+  }
+  double rate = 50;
+  double seconds = 5;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    if ((arg == "-r" || arg == "--rate") && i + 1 < argc)
+      rate = atof(argv[++i]);
+    else if ((arg == "-t" || arg == "--seconds") && i + 1 < argc)
+      seconds = atof(argv[++i]);
+    else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  sim::FdTransport *link = sim::FdTransport::openDevice(argv[1]);
+  if (link == 0) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  unsigned long frames = 0;
+  unsigned long received = 0;
+  steady_clock::time_point start = steady_clock::now();
+  steady_clock::time_point end = start + duration_cast<steady_clock::duration>(duration<double>(seconds));
+  steady_clock::duration period = duration_cast<steady_clock::duration>(duration<double>(1.0 / rate));
+  steady_clock::time_point next = start;
+  while (steady_clock::now() < end) {
+    //sweep the setpoints so that every frame is different
+    int speed = (int)(frames % 511) - 255;
+    unsigned char payload[5];
+    unsigned char frame[5 + FRAME_OVERHEAD];
+    payload[0] = rohrah::RemoteControlCommand::moveCommand;
+    rohrah::writeInt16(payload + 1, speed);
+    rohrah::writeInt16(payload + 3, -speed);
+    link->write(frame, rohrah::encodeFrame(frame, FRAME_DRIVE, payload, sizeof(payload)));
+    frames++;
+    while (link->read() >= 0)
+      received++;
+    next += period;
+    std::this_thread::sleep_until(next);
+  }
+  link->write((const uint8_t *)"s", 1);
+
+  printf("sent %lu frames (%lu bytes) in %.1f s, %lu bytes dropped, %lu bytes received\n",
+         frames, frames * (5 + FRAME_OVERHEAD), seconds, link->getDropped(), received);
+
+  link->write((const uint8_t *)"P", 1);
+  steady_clock::time_point quiet = steady_clock::now() + milliseconds(2000);
+  while (steady_clock::now() < quiet) {
+    int b = link->read();
+    if (b >= 0)
+      putchar(b);
+    else
+      std::this_thread::sleep_for(milliseconds(5));
+  }
+  delete link;
+  return 0;
+}
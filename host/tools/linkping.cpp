@@ -0,0 +1,201 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FdTransport.h"
+#include "Frame.h"
+#include "RemoteControlCommand.h"
+
+using namespace std::chrono;
+
+#define NUM_BUCKETS 8
+#define FIRST_BUCKET 8 //ms, as in LinkMonitor.cpp
+
+static void usage(const char *name) {
+  fprintf(stderr,
+    "usage: %s DEVICE [options]\n"
+    "Ping the robot over its Bluetooth link, answer its probes, and print the round trip\n"
+    "times seen from here and, asked for with 'L' at the end, from the robot.\n"
+    "  -r, --rate N        pings per second (default 10)\n"
+    "  -t, --seconds N     how long to keep pinging (default 10)\n"
+    "  -d, --drive L:R     drive at speeds L and R from the start\n"
+    "  -w, --watchdog MS   set the robot's watchdog timeout first, 0 to switch it off\n"
+    "      --drop S        go quiet for the last S seconds, as if the link dropped\n", name);
+}
+
+static unsigned long clockMicros(steady_clock::time_point start) {
+  return (unsigned long)duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+static void send(sim::FdTransport *link, unsigned char type, const unsigned char *payload, unsigned char length) {
+  unsigned char frame[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD];
+  link->write(frame, rohrah::encodeFrame(frame, type, payload, length));
+}
+
+/**
+ * Host client of the link checks in LinkMonitor.h.  DEVICE is a serial port, or the pty
+ * printed by rohrahsim --pty --realtime.  Prints the round trips of its own pings: how
+ * many were lost, the mean, median, 95th percentile and worst, and a histogram with the
+ * robot's buckets, then the robot's own report
+ */
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    usage(argv[0]);
+    return 1;
+  }
+  double rate = 10;
+  double seconds = 10;
+  double drop = 0;
+  bool drive = false;
+  int left = 0, right = 0;
+  long watchdog = -1;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if ((arg == "-r" || arg == "--rate") && hasValue)
+      rate = atof(argv[++i]);
+    else if ((arg == "-t" || arg == "--seconds") && hasValue)
+      seconds = atof(argv[++i]);
+    else if ((arg == "-d" || arg == "--drive") && hasValue && sscanf(argv[i + 1], "%d:%d", &left, &right) == 2) {
+      drive = true;
+      i++;
+    }
+    else if ((arg == "-w" || arg == "--watchdog") && hasValue)
+      watchdog = atol(argv[++i]);
+    else if (arg == "--drop" && hasValue)
+      drop = atof(argv[++i]);
+    else {
+      usage(argv[0]);
+      return arg == "-h" || arg == "--help" ? 0 : 1;
+    }
+  }
+
+  sim::FdTransport *link = sim::FdTransport::openDevice(argv[1]);
+  if (link == 0) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  steady_clock::time_point start = steady_clock::now();
+  unsigned char payload[5];
+  if (watchdog >= 0) {
+    rohrah::writeInt16(payload, (int)watchdog);
+    send(link, FRAME_WATCHDOG, payload, 2);
+  }
+  if (drive) {
+    payload[0] = rohrah::RemoteControlCommand::moveCommand;
+    rohrah::writeInt16(payload + 1, left);
+    rohrah::writeInt16(payload + 3, right);
+    send(link, FRAME_DRIVE, payload, 5);
+  }
+
+  rohrah::FrameParser parser;
+  std::string text; //whatever the robot printed
+  std::vector<double> trips; //ms
+  unsigned long pings = 0, probes = 0, late = 0;
+  unsigned char sequence = 0;
+  steady_clock::time_point quiet = start + duration_cast<steady_clock::duration>(duration<double>(seconds - drop));
+  steady_clock::time_point end = start + duration_cast<steady_clock::duration>(duration<double>(seconds));
+  steady_clock::duration period = duration_cast<steady_clock::duration>(duration<double>(1.0 / rate));
+  steady_clock::time_point next = start;
+  steady_clock::time_point asked = end; //when 'L' went out
+  bool reported = false;
+  while (!reported || steady_clock::now() < asked + milliseconds(1000)) {
+    steady_clock::time_point now = steady_clock::now();
+    bool talking = now < quiet || now >= end;
+    if (now < quiet && now >= next) {
+      payload[0] = ++sequence;
+      rohrah::writeUint32(payload + 1, clockMicros(start));
+      send(link, FRAME_PING, payload, 5);
+      pings++;
+      next += period;
+    }
+    if (now >= end && !reported) {
+      link->write((const uint8_t *)"L", 1);
+      asked = now;
+      reported = true;
+    }
+    int b;
+    while ((b = link->read()) >= 0) {
+      if (parser.isIdle() && b != FRAME_SYNC) {
+        text += (char)b;
+        continue;
+      }
+      if (!parser.parse((unsigned char)b))
+        continue;
+      if (parser.getType() == FRAME_ECHO && parser.getLength() == 5) {
+        if (parser.getPayload()[0] != sequence)
+          late++;
+        trips.push_back((clockMicros(start) - rohrah::readUint32(parser.getPayload() + 1)) / 1000.0);
+      }
+      else if (parser.getType() == FRAME_PROBE && talking) {
+        send(link, FRAME_PONG, parser.getPayload(), parser.getLength());
+        probes++;
+      }
+    }
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+  delete link;
+
+  printf("pings          %lu sent, %lu lost, %lu overtaken by the next, %lu probes answered\n", pings,
+         pings - std::min(pings, (unsigned long)trips.size()), late, probes);
+  if (!trips.empty()) {
+    std::vector<double> sorted = trips;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (double t : trips)
+      sum += t;
+    printf("round trip ms  mean %.1f, median %.1f, 95%% %.1f, min %.1f, max %.1f\n", sum / trips.size(),
+           sorted[sorted.size() / 2], sorted[sorted.size() * 95 / 100], sorted.front(), sorted.back());
+    unsigned long buckets[NUM_BUCKETS] = { 0 };
+    for (double t : trips) {
+      int bucket = 0;
+      for (double top = FIRST_BUCKET; t >= top && bucket < NUM_BUCKETS - 1; top *= 2)
+        bucket++;
+      buckets[bucket]++;
+    }
+    printf("histogram     ");
+    for (int i = 0; i < NUM_BUCKETS - 1; i++)
+      printf(" <%d:%lu", FIRST_BUCKET << i, buckets[i]);
+    printf(" more:%lu\n", buckets[NUM_BUCKETS - 1]);
+  }
+  printf("robot says\n%s", text.c_str());
+  return 0;
+}
@@ -0,0 +1,142 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Logger.h"
+
+using rohrah::Logger;
+
+#define LOG_MESSAGE_FORMAT(id, format) format,
+static const char *formats[] = { LOG_MESSAGES(LOG_MESSAGE_FORMAT) };
+#undef LOG_MESSAGE_FORMAT
+
+/**
+ * Number of %d conversions in a message format
+ */
+static unsigned countArgs(const char *format) {
+  unsigned n = 0;
+  for (const char *p = format; *p; p++) {
+    if (p[0] == '%' && p[1] == 'd')
+      n++;
+  }
+  return n;
+}
+
+/**
+ * Read a varint starting at pos.  Returns false if the data ends first or it is too long
+ */
+static bool readVarint(const std::vector<unsigned char> &data, size_t &pos, unsigned long long &value) {
+  value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (pos >= data.size())
+      return false;
+    unsigned char b = data[pos++];
+    value |= (unsigned long long)(b & 0x7f) << shift;
+    if ((b & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+static std::string format(const char *fmt, const std::vector<long long> &args) {
+  std::string out;
+  size_t next = 0;
+  for (const char *p = fmt; *p; p++) {
+    if (p[0] == '%' && p[1] == 'd') {
+      out += std::to_string(next < args.size() ? args[next++] : 0);
+      p++;
+    }
+    else {
+      out += *p;
+    }
+  }
+  return out;
+}
+
+/**
+ * Turn the binary log written by rohrah::Logger back into text, one line per record
+ * with the time stamp in ms since the first record.  Garbage and partial records,
+ * e.g. from attaching to a running robot, are skipped.
+ *
+ * usage: logdecode [file]   (reads stdin without a file)
+ */
+int main(int argc, char **argv) {
+  FILE *in = stdin;
+  if (argc > 1) {
+    in = fopen(argv[1], "rb");
+    if (in == 0) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+  std::vector<unsigned char> data;
+  unsigned char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0)
+    data.insert(data.end(), chunk, chunk + n);
+
+  unsigned long long time = 0;
+  bool synced = false;
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t start = pos;
+    if (data[pos++] != Logger::LOG_SYNC || pos + 2 > data.size())
+      continue;
+    unsigned id = data[pos++];
+    unsigned count = data[pos++];
+    if (id >= Logger::numMessages || count != countArgs(formats[id])) {
+      pos = start + 1;
+      continue;
+    }
+    unsigned long long delta;
+    std::vector<long long> args;
+    bool ok = readVarint(data, pos, delta);
+    for (unsigned i = 0; ok && i < count; i++) {
+      unsigned long long zigzag;
+      ok = readVarint(data, pos, zigzag);
+      args.push_back((long long)(zigzag >> 1) ^ -(long long)(zigzag & 1));
+    }
+    if (!ok) {
+      pos = start + 1;
+      continue;
+    }
+    //the first delta after attaching is relative to a record we never saw
+    time = synced ? time + delta : 0;
+    synced = true;
+    printf("%10llu ms  %s\n", time, format(formats[id], args).c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,149 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FdTransport.h"
+#include "MotionAssembler.h"
+#include "RobotConfig.h"
+
+using namespace std::chrono;
+
+static void usage(const char *name) {
+  fprintf(stderr,
+    "usage: %s SCRIPT [options]\n"
+    "Assemble a motion script (see MotionAssembler.h) and upload it to the robot in\n"
+    "FRAME_SCRIPT frames.  Without --out it is only checked.\n"
+    "  -o, --out DEVICE    send the frames to a serial port or pty, or - for stdout\n"
+    "  -r, --run           send 'S' after the upload to run the script\n"
+    "  -l, --list          print the script as the robot gets it\n"
+    "  -w, --wait S        print what the robot sends back for S seconds (default 1)\n"
+    "      --size N        bytes of script the robot has room for (default %u)\n",
+    name, (unsigned)rohrah::StandardConfig::SCRIPT_SIZE);
+}
+
+/**
+ * Host assembler for motion scripts.  SCRIPT is a file, or - for stdin.  DEVICE is a
+ * serial port, or the pty printed by rohrahsim --pty --realtime.  rohrahsim --script-at
+ * runs a script in the simulator without one
+ */
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    usage(argv[0]);
+    return 1;
+  }
+  const char *out = 0;
+  bool run = false;
+  bool list = false;
+  double wait = 1;
+  unsigned long size = rohrah::StandardConfig::SCRIPT_SIZE;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if ((arg == "-o" || arg == "--out") && hasValue)
+      out = argv[++i];
+    else if (arg == "-r" || arg == "--run")
+      run = true;
+    else if (arg == "-l" || arg == "--list")
+      list = true;
+    else if ((arg == "-w" || arg == "--wait") && hasValue)
+      wait = atof(argv[++i]);
+    else if (arg == "--size" && hasValue)
+      size = strtoul(argv[++i], 0, 10);
+    else {
+      usage(argv[0]);
+      return arg == "-h" || arg == "--help" ? 0 : 1;
+    }
+  }
+
+  std::string path = argv[1];
+  std::ifstream file;
+  if (path != "-") {
+    file.open(path);
+    if (!file) {
+      perror(path.c_str());
+      return 1;
+    }
+  }
+  std::vector<unsigned char> code;
+  std::string error;
+  if (!tools::assembleScript(path == "-" ? std::cin : file, code, error)) {
+    fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+    return 1;
+  }
+  if (code.size() > size) {
+    fprintf(stderr, "%s: %zu bytes, the robot has room for %lu\n", path.c_str(), code.size(), size);
+    return 1;
+  }
+  std::string frames = tools::scriptFrames(code);
+  if (list)
+    fprintf(stderr, "%s", tools::disassembleScript(code).c_str());
+  fprintf(stderr, "%zu bytes of %lu, %zu bytes to upload\n", code.size(), size, frames.size());
+  if (run)
+    frames += 'S';
+  if (out == 0)
+    return 0;
+
+  if (std::string(out) == "-") {
+    fwrite(frames.data(), 1, frames.size(), stdout);
+    return 0;
+  }
+  sim::FdTransport *link = sim::FdTransport::openDevice(out);
+  if (link == 0) {
+    perror(out);
+    return 1;
+  }
+  link->write((const uint8_t *)frames.data(), frames.size());
+  steady_clock::time_point quiet = steady_clock::now() + duration_cast<steady_clock::duration>(duration<double>(wait));
+  while (steady_clock::now() < quiet) {
+    int b = link->read();
+    if (b >= 0)
+      putchar(b);
+    else
+      std::this_thread::sleep_for(milliseconds(5));
+  }
+  int dropped = link->getDropped();
+  delete link;
+  if (dropped) {
+    fprintf(stderr, "%s: %d bytes dropped, upload again\n", out, dropped);
+    return 1;
+  }
+  return 0;
+}
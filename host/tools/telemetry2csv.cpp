@@ -0,0 +1,164 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <cstdio>
+
+#include "Frame.h"
+#include "Telemetry.h"
+
+using rohrah::FrameParser;
+using rohrah::Telemetry;
+
+static const char *header = "time_ms,state,raw_distance,distance,left_speed,right_speed,loop_us,command";
+
+/**
+ * Read a varint at pos within a payload of length bytes.  Returns false if it runs off the end
+ */
+static bool readVarint(const unsigned char *payload, unsigned length, unsigned &pos, unsigned long long &value) {
+  value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (pos >= length)
+      return false;
+    unsigned char b = payload[pos++];
+    value |= (unsigned long long)(b & 0x7f) << shift;
+    if ((b & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+static bool readZigzag(const unsigned char *payload, unsigned length, unsigned &pos, long long &value) {
+  unsigned long long zigzag;
+  if (!readVarint(payload, length, pos, zigzag))
+    return false;
+  value = (long long)(zigzag >> 1) ^ -(long long)(zigzag & 1);
+  return true;
+}
+
+/**
+ * Rebuild the time series sent by rohrah::Telemetry and print it as CSV, one row per sample.
+ * Everything on the link that is not a telemetry frame is skipped.  Delta frames are only
+ * used once a key frame has been seen and while no sample is missing, so a gap in the
+ * sequence numbers costs the samples up to the next key frame.  A summary goes to stderr.
+ *
+ * usage: telemetry2csv [file]   (reads stdin without a file, e.g. a serial port)
+ */
+int main(int argc, char **argv) {
+  FILE *in = stdin;
+  if (argc > 1) {
+    in = fopen(argv[1], "rb");
+    if (in == 0) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+
+  FrameParser parser;
+  bool synced = false;
+  unsigned char expected = 0;
+  unsigned long long time = 0;
+  long long fields[Telemetry::numFields] = {0};
+  unsigned long bytes = 0, telemetryBytes = 0, keys = 0, deltas = 0, lost = 0, skipped = 0;
+  int c;
+
+  printf("%s\n", header);
+  while ((c = fgetc(in)) != EOF) {
+    bytes++;
+    if (!parser.parse((unsigned char)c))
+      continue;
+    unsigned type = parser.getType();
+    if (type != FRAME_TELEMETRY_KEY && type != FRAME_TELEMETRY_DELTA)
+      continue;
+    const unsigned char *payload = parser.getPayload();
+    unsigned length = parser.getLength();
+    telemetryBytes += length + FRAME_OVERHEAD;
+    if (length < 1)
+      continue;
+    unsigned char sequence = payload[0];
+    unsigned pos = 1;
+    if (synced && sequence != expected) {
+      lost += (unsigned char)(sequence - expected);
+      synced = false;
+    }
+    expected = sequence + 1;
+
+    long long values[Telemetry::numFields];
+    unsigned long long t;
+    bool ok;
+    if (type == FRAME_TELEMETRY_KEY) {
+      ok = readVarint(payload, length, pos, t);
+      for (int i = 0; ok && i < Telemetry::numFields; i++)
+        ok = readZigzag(payload, length, pos, values[i]);
+      if (!ok)
+        continue;
+      keys++;
+      time = t;
+      synced = true;
+    }
+    else {
+      if (!synced || length < 2) {
+        skipped++;
+        continue;
+      }
+      unsigned char mask = payload[pos++];
+      ok = readVarint(payload, length, pos, t);
+      for (int i = 0; ok && i < Telemetry::numFields; i++) {
+        values[i] = fields[i];
+        long long delta = 0;
+        if (mask & (1 << i)) {
+          ok = readZigzag(payload, length, pos, delta);
+          values[i] += delta;
+        }
+      }
+      if (!ok) {
+        synced = false;
+        continue;
+      }
+      deltas++;
+      time += t;
+    }
+
+    printf("%llu", time);
+    for (int i = 0; i < Telemetry::numFields; i++) {
+      fields[i] = values[i];
+      printf(",%lld", fields[i]);
+    }
+    printf("\n");
+  }
+
+  unsigned long samples = keys + deltas;
+  fprintf(stderr, "%lu samples (%lu key, %lu delta), %lu lost, %lu skipped waiting for a key frame\n",
+          samples, keys, deltas, lost, skipped);
+  fprintf(stderr, "%lu telemetry bytes of %lu read, %.1f bytes per sample, %u frame errors\n",
+          telemetryBytes, bytes, samples ? (double)telemetryBytes / samples : 0.0, parser.getErrors());
+  return 0;
+}
@@ -0,0 +1,353 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "Board.h"
+#include "Frame.h"
+#include "LinkQueue.h"
+#include "Robot.h"
+#include "Trace.h"
+
+using rohrah::FrameParser;
+using rohrah::LinkQueue;
+using rohrah::Trace;
+
+/**
+ * One decoded trace record.  Times are absolute, rebuilt from the differences in the trace
+ */
+struct Record {
+  int type;
+  int argument;
+  long long a;  // control: time in ms, sample: cm, random: value, motors: left output
+  long long b;  // sample: time in us, motors: right output
+  std::string bytes;  // received
+
+  bool operator==(const Record &other) const {
+    return type == other.type && argument == other.argument && a == other.a && b == other.b && bytes == other.bytes;
+  }
+};
+
+/**
+ * The frames of a trace and what became of them
+ */
+struct TraceFile {
+  std::vector<unsigned char> records;  // the payloads without their sequence numbers, in order
+  unsigned long frames;
+  unsigned long lost;  // frames missing after the first gap, which is where the trace ends
+  bool complete;  // no gap
+  TraceFile(): frames(0), lost(0), complete(true) {}
+
+  void add(const unsigned char *payload, unsigned length) {
+    if (length < 1 || !complete)
+      return;
+    unsigned char expected = (unsigned char)frames;
+    if (payload[0] != expected) {
+      lost = (unsigned char)(payload[0] - expected);
+      complete = false;
+      return;
+    }
+    frames++;
+    records.insert(records.end(), payload + 1, payload + length);
+  }
+};
+
+static bool readVarint(const std::vector<unsigned char> &in, size_t &pos, unsigned long long &value) {
+  value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (pos >= in.size())
+      return false;
+    unsigned char b = in[pos++];
+    value |= (unsigned long long)(b & 0x7f) << shift;
+    if ((b & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+static bool readZigzag(const std::vector<unsigned char> &in, size_t &pos, long long &value) {
+  unsigned long long zigzag;
+  if (!readVarint(in, pos, zigzag))
+    return false;
+  value = (long long)(zigzag >> 1) ^ -(long long)(zigzag & 1);
+  return true;
+}
+
+/**
+ * Turn the record bytes of a trace back into records.  Stops at anything malformed
+ */
+static std::vector<Record> decode(const std::vector<unsigned char> &in) {
+  std::vector<Record> records;
+  size_t pos = 0;
+  unsigned long control = 0, sample = 0;
+  long long left = 0, right = 0;
+  while (pos < in.size()) {
+    Record r = { in[pos] >> 5, in[pos] & Trace::MAX_ARGUMENT, 0, 0, "" };
+    pos++;
+    unsigned long long u = 0;
+    bool ok = true;
+    switch (r.type) {
+      case Trace::recordControl:
+        u = r.argument;
+        if (r.argument == Trace::MAX_ARGUMENT)
+          ok = readVarint(in, pos, u);
+        control += (unsigned long)u;
+        r.a = control;
+        r.argument = 0;
+        break;
+      case Trace::recordSample:
+        ok = readVarint(in, pos, u);
+        r.a = u;
+        ok = ok && readVarint(in, pos, u);
+        sample += (unsigned long)u;
+        r.b = sample;
+        break;
+      case Trace::recordReceived:
+        ok = pos + r.argument <= in.size();
+        if (ok)
+          r.bytes.assign(in.begin() + pos, in.begin() + pos + r.argument);
+        pos += r.argument;
+        break;
+      case Trace::recordRandom:
+        ok = readZigzag(in, pos, r.a);
+        break;
+      case Trace::recordState:
+        break;
+      case Trace::recordMotors: {
+        long long dl = 0, dr = 0;
+        ok = readZigzag(in, pos, dl) && readZigzag(in, pos, dr);
+        left += dl;
+        right += dr;
+        r.a = left;
+        r.b = right;
+        break;
+      }
+      default:
+        ok = false;
+    }
+    if (!ok)
+      break;
+    records.push_back(r);
+  }
+  return records;
+}
+
+static std::string describe(const Record &r) {
+  char text[160];
+  switch (r.type) {
+    case Trace::recordControl:
+      snprintf(text, sizeof(text), "control pass at %lld ms", r.a);
+      break;
+    case Trace::recordSample:
+      snprintf(text, sizeof(text), "sensor %d sample %lld cm%s at %lld us", r.argument >> 1, r.a, r.argument & 1 ? "" : " (no echo)", r.b);
+      break;
+    case Trace::recordReceived: {
+      std::string shown;
+      for (size_t i = 0; i < r.bytes.size(); i++) {
+        unsigned char c = r.bytes[i];
+        char hex[8];
+        snprintf(hex, sizeof(hex), c >= 0x20 && c < 0x7f ? "%c" : "\\x%02x", c);
+        shown += hex;
+      }
+      snprintf(text, sizeof(text), "received \"%s\"", shown.c_str());
+      break;
+    }
+    case Trace::recordRandom:
+      snprintf(text, sizeof(text), "random %lld", r.a);
+      break;
+    case Trace::recordState:
+      snprintf(text, sizeof(text), "state %d", r.argument);
+      break;
+    case Trace::recordMotors:
+      snprintf(text, sizeof(text), "motors %lld %lld", r.a, r.b);
+      break;
+    default:
+      snprintf(text, sizeof(text), "record type %d", r.type);
+  }
+  return text;
+}
+
+/**
+ * The remote control link of the replayed robot.  Serves the bytes recorded for a pass
+ * and throws away whatever the robot sends
+ */
+class ReplayLink : public rohrah::Transport {
+  public:
+    std::deque<unsigned char> rx;
+    void begin(unsigned long /*baud*/) {}
+    int available() { return (int)rx.size(); }
+    int read() { if (rx.empty()) return -1; int b = rx.front(); rx.pop_front(); return b; }
+    int peek() { return rx.empty() ? -1 : rx.front(); }
+    int availableForWrite() { return 255; }
+    size_t write(uint8_t /*b*/) { return 1; }
+    using Print::write;
+};
+
+/**
+ * Collects the frames of the trace the replayed robot records
+ */
+class TraceCollector : public Print {
+  public:
+    TraceFile trace;
+    int availableForWrite() { return 255; }
+    size_t write(uint8_t b) {
+      if (parser.parse(b) && parser.getType() == FRAME_TRACE)
+        trace.add(parser.getPayload(), parser.getLength());
+      return 1;
+    }
+    using Print::write;
+  private:
+    FrameParser parser;
+};
+
+/**
+ * The robot with its passes driven from a trace instead of the scheduler and the sensors
+ */
+class ReplayRobot : public rohrah::Robot<rohrah::StandardConfig> {
+  public:
+    ReplayRobot(rohrah::Transport *link): Robot(link) {}
+    void control(unsigned long time) { controlTask(time); }
+    void sample(unsigned char index, unsigned int cm, bool echo, unsigned long time) { replaySample(index, cm, echo, time); }
+};
+
+/**
+ * Replay a trace recorded by the firmware with TRACING defined (see Trace.h) through this
+ * build of the firmware, and check that it makes the same decisions: the replayed robot
+ * records a trace of its own, which has to match the original record for record, inputs
+ * and outputs alike.  The first record that differs is printed.  Also reports how long the
+ * control passes took on the host, to compare the cost of firmware versions on the same input.
+ *
+ * The trace has to start when the robot does.  Everything on the link that is not a trace
+ * frame is skipped, and the replay stops at the first lost frame.
+ *
+ * usage: tracereplay [file]   (reads stdin without a file, e.g. rohrahsim --bt-out -)
+ * Exits with 1 if the replay diverged
+ */
+int main(int argc, char **argv) {
+  FILE *in = stdin;
+  if (argc > 1) {
+    in = fopen(argv[1], "rb");
+    if (in == 0) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+
+  FrameParser parser;
+  TraceFile original;
+  int c;
+  while ((c = fgetc(in)) != EOF) {
+    if (parser.parse((unsigned char)c) && parser.getType() == FRAME_TRACE)
+      original.add(parser.getPayload(), parser.getLength());
+  }
+  std::vector<Record> records = decode(original.records);
+  printf("trace          %lu frames, %lu records%s\n", original.frames, (unsigned long)records.size(),
+         original.complete ? "" : ", ends at a gap in the sequence");
+  if (records.empty())
+    return 0;
+
+  sim::Board::current().usb.onWrite = [](uint8_t) {};  //the Logger's output is of no interest
+  ReplayLink link;
+  TraceCollector replayed;
+  ReplayRobot robot(&link);
+  robot.begin();  //as at power on, which sets the drive train the odometry reckons with
+  unsigned long passes = 0, samples = 0, received = 0, randoms = 0;
+  double passTime = 0, maxPassTime = 0;
+
+  for (size_t i = 0; i < records.size(); i++) {
+    const Record &r = records[i];
+    if (r.type == Trace::recordControl) {
+      //the inputs the pass went on to read
+      for (size_t j = i + 1; j < records.size(); j++) {
+        const Record &input = records[j];
+        if (input.type == Trace::recordControl || input.type == Trace::recordSample)
+          break;
+        if (input.type == Trace::recordReceived) {
+          link.rx.insert(link.rx.end(), input.bytes.begin(), input.bytes.end());
+          received += input.bytes.size();
+        }
+        else if (input.type == Trace::recordRandom) {
+          Trace::replayRandom(input.a);
+          randoms++;
+        }
+      }
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      robot.control((unsigned long)r.a);
+      double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      passTime += elapsed;
+      if (elapsed > maxPassTime)
+        maxPassTime = elapsed;
+      passes++;
+    }
+    else if (r.type == Trace::recordSample) {
+      robot.sample(r.argument >> 1, (unsigned int)r.a, r.argument & 1, (unsigned long)r.b);
+      samples++;
+    }
+    LinkQueue::drain(replayed, 255);
+  }
+  Trace::flush();
+  LinkQueue::drain(replayed, 255);
+
+  std::vector<Record> result = decode(replayed.trace.records);
+  unsigned long states = 0, motors = 0;
+  for (size_t i = 0; i < records.size(); i++) {
+    if (records[i].type == Trace::recordState)
+      states++;
+    else if (records[i].type == Trace::recordMotors)
+      motors++;
+  }
+  printf("replayed       %lu control passes, %lu samples, %lu bytes received, %lu random numbers\n",
+         passes, samples, received, randoms);
+  printf("outputs        %lu state changes, %lu motor changes\n", states, motors);
+  printf("host time      mean %.2f us, max %.2f us per control pass\n", passes ? passTime / passes : 0, maxPassTime);
+
+  //the original may end part way through a pass, the replay always finishes it
+  for (size_t i = 0; i < records.size(); i++) {
+    if (i >= result.size() || !(result[i] == records[i])) {
+      unsigned long long time = 0;
+      for (size_t j = 0; j <= i; j++) {
+        if (records[j].type == Trace::recordControl)
+          time = records[j].a;
+      }
+      printf("diverged       at record %lu, in the pass at %llu ms\n", (unsigned long)i, time);
+      printf("  recorded     %s\n", describe(records[i]).c_str());
+      printf("  replayed     %s\n", i < result.size() ? describe(result[i]).c_str() : "nothing");
+      return 1;
+    }
+  }
+  printf("identical      every record matches\n");
+  return 0;
+}
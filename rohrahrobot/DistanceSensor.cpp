@@ -30,29 +30,173 @@
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 
+#include <Arduino.h>
 #include "DistanceSensor.h"
 using namespace rohrah;
 
+#define PING_INTERVAL 30000 //us between pings, lets the echoes of the previous ping die out
+#define ECHO_START_TIMEOUT 1000 //us the sensor may take to send its burst and raise the echo line
+
+// the sensor whose echo the interrupt is currently timing
+MCU_LOCAL DistanceSensor *DistanceSensor::activeSensor = 0;
+
 /**
  * Constructor
  * Initialize the trigger pin, echo pin and max distance of the ultrasonic sensor
  * This sensor uses the NewPing library
  */
-DistanceSensor::DistanceSensor(int triggerPin, int echoPin, int maxDistance) : sensor(triggerPin, echoPin, maxDistance) {
+DistanceSensor::DistanceSensor(int triggerPin, int echoPin, int maxDistance) : sensor(triggerPin, echoPin, maxDistance),
+                 maxRange(maxDistance), maxDistance(maxDistance), triggerPin(triggerPin), echoPin(echoPin), async(false), pinging(false),
+                 pingTime(0), pingTimeout(0), echoStart(0), echoEnd(0), echoDone(false), distance(maxDistance), echo(false), sampleTime(0) {
 }
 
 /**
  * Destructor
  */
-DistanceSensor::~DistanceSensor() {}
+DistanceSensor::~DistanceSensor() {
+  if (async)
+    detachInterrupt(digitalPinToInterrupt(echoPin));
+  if (activeSensor == this)
+    activeSensor = 0;
+}
 
 /**  
  * Get the distance in cm  
+ * In asynchronous mode this is the newest completed sample, otherwise the sensor is pinged
+ * and the call blocks until the echo comes back or times out
  */
 unsigned int DistanceSensor::getDistance() {
-    int distance = sensor.ping_cm();
+    if (async)
+      return distance;
+    int distance = sensor.ping_cm(maxDistance);
+    echo = distance > 0;
     if (distance <= 0)
       return maxDistance;
     return distance;
 }
-
+
+/**
+ * Switch to asynchronous ranging.  The echo pin is timed by an external interrupt
+ * Returns false, and stays in blocking mode, if the echo pin cannot interrupt
+ */
+bool DistanceSensor::beginAsync() {
+  if (digitalPinToInterrupt(echoPin) == NOT_AN_INTERRUPT)
+    return false;
+  pinMode(triggerPin, OUTPUT);
+  digitalWrite(triggerPin, LOW);
+  pinMode(echoPin, INPUT);
+  attachInterrupt(digitalPinToInterrupt(echoPin), echoInterrupt, CHANGE);
+  async = true;
+  return true;
+}
+
+/**
+ * Call regularly in asynchronous mode, at least every PING_INTERVAL for the full sample rate.
+ * Collects the echo timed by the interrupt and fires the next ping once the sensor is idle.
+ * Returns true when a new sample is available from getDistance()
+ */
+bool DistanceSensor::update(unsigned long currentMicros) {
+  if (!async)
+    return false;
+  bool fresh = collect(currentMicros);
+  if (!pinging && currentMicros - pingTime >= PING_INTERVAL)
+    startPing(currentMicros);
+  return fresh;
+}
+
+/**
+ * Only listen for echoes up to cm away, at most the range the sensor was constructed with.
+ * A ping in flight keeps the window it was fired with
+ */
+void DistanceSensor::setMaxDistance(unsigned int cm) {
+  if (cm == 0 || cm > maxRange)
+    cm = maxRange;
+  maxDistance = cm;
+}
+
+/**
+ * How long a ping may take before it counts as nothing within cm, in us
+ */
+unsigned long DistanceSensor::timeoutFor(unsigned int cm) {
+  return ECHO_START_TIMEOUT + (unsigned long)cm * US_ROUNDTRIP_CM;
+}
+
+/**
+ * Check on the ping in flight.  Takes the echo timed by the interrupt, or gives up once
+ * the timeout it was fired with has passed.  Returns true when that produced a new sample
+ */
+bool DistanceSensor::collect(unsigned long currentMicros) {
+  if (!async || !pinging)
+    return false;
+  noInterrupts();
+  bool done = echoDone;
+  unsigned long start = echoStart;
+  unsigned long end = echoEnd;
+  interrupts();
+
+  if (done) {
+    unsigned int cm = (end - start + US_ROUNDTRIP_CM / 2) / US_ROUNDTRIP_CM;
+    if (cm == 0)
+      cm = 1; //an echo came back, so something is there
+    distance = cm > maxDistance ? maxDistance : cm;
+    echo = cm <= maxDistance;
+    sampleTime = end;
+    pinging = false;
+    return true;
+  }
+  if (currentMicros - pingTime > pingTimeout) {
+    //nothing within range
+    distance = maxDistance;
+    echo = false;
+    sampleTime = currentMicros;
+    pinging = false;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Fire a ping unless one is in flight or the echo line is still high, the sensor does not
+ * listen to a new trigger until it is low.  Returns true if the ping went out
+ */
+bool DistanceSensor::startPing(unsigned long currentMicros) {
+  if (!async || pinging || digitalRead(echoPin) != LOW)
+    return false;
+  firePing(currentMicros);
+  return true;
+}
+
+/**
+ * Send the 10us trigger pulse and let the interrupt time the echo
+ */
+void DistanceSensor::firePing(unsigned long currentMicros) {
+  noInterrupts();
+  activeSensor = this;
+  echoStart = 0;
+  echoDone = false;
+  interrupts();
+  digitalWrite(triggerPin, LOW);
+  delayMicroseconds(4);
+  digitalWrite(triggerPin, HIGH);
+  delayMicroseconds(10);
+  digitalWrite(triggerPin, LOW);
+  pingTime = currentMicros;
+  pingTimeout = getTimeout();
+  pinging = true;
+}
+
+/**
+ * Echo pin change interrupt: time stamp the rising and the falling edge of the echo
+ */
+void DistanceSensor::echoInterrupt() {
+  DistanceSensor *s = activeSensor;
+  if (s == 0 || s->echoDone)
+    return;
+  if (digitalRead(s->echoPin) == HIGH) {
+    s->echoStart = micros();
+  }
+  else if (s->echoStart != 0) {
+    s->echoEnd = micros();
+    s->echoDone = true;
+  }
+}
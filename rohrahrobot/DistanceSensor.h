@@ -34,6 +34,7 @@
 #define _DISTANCE_SENSOR_H_
 
 #include <NewPing.h>
+#include "McuLocal.h"
 
 namespace rohrah {
 
@@ -42,12 +43,62 @@ namespace rohrah {
       DistanceSensor(int triggerPin, int echoPin, int maxDistance);
       ~DistanceSensor();
       unsigned int getDistance();
+      bool hasEcho() const { return echo; } //false if the newest sample saw nothing within range
+
+      /**
+       * Asynchronous ranging.  After beginAsync() the echo is timed in an interrupt,
+       * update() fires the next ping when the sensor is idle, and getDistance() returns
+       * the newest completed sample without blocking.
+       * The echo pin must be an external interrupt pin (2 or 3 on the Uno)
+       */
+      bool beginAsync();
+      bool update(unsigned long currentMicros);
+      bool isAsync() const { return async; }
+
+      /**
+       * The two halves of update(), for sensors that take turns (see SensorArray).
+       * startPing() fires if the echo line is low, collect() checks on the ping in flight
+       */
+      bool startPing(unsigned long currentMicros);
+      bool collect(unsigned long currentMicros);
+      bool isPinging() const { return pinging; }
+      unsigned long getTimeout() const { return timeoutFor(maxDistance); }
+      static unsigned long timeoutFor(unsigned int cm);
+
+      /**
+       * Range gating.  Echoes from beyond maxDistance are not waited for, and read as
+       * maxDistance.  The range can be narrowed and widened again at run time, up to the
+       * maximum the sensor was constructed with
+       */
+      void setMaxDistance(unsigned int cm);
+      unsigned int getMaxDistance() const { return maxDistance; }
+      unsigned int getMaxRange() const { return maxRange; }
+      unsigned long getSampleTime() const { return sampleTime; }
+      unsigned long getSampleAge(unsigned long currentMicros) const { return currentMicros - sampleTime; }
 
     private:
+      static void echoInterrupt();
+      static MCU_LOCAL DistanceSensor *activeSensor;
+
+      void firePing(unsigned long currentMicros);
+
       NewPing sensor;
-      unsigned int maxDistance;  
+      unsigned int maxRange;
+      unsigned int maxDistance;
+      unsigned char triggerPin;
+      unsigned char echoPin;
+      bool async;
+      bool pinging;
+      unsigned long pingTime;
+      unsigned long pingTimeout;
+      volatile unsigned long echoStart;
+      volatile unsigned long echoEnd;
+      volatile bool echoDone;
+      unsigned int distance;
+      bool echo;
+      unsigned long sampleTime;
   };
   
 }
 
-#endif
+#endif
@@ -0,0 +1,74 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _EXPONENTIAL_MOVING_AVERAGE_H_
+#define _EXPONENTIAL_MOVING_AVERAGE_H_
+
+namespace rohrah {
+
+  /**
+   * Exponential moving average with a smoothing factor of 1 / 2^SHIFT, in fixed point.
+   * The state is the average scaled by 2^SHIFT, so add() is a subtract, an add and a
+   * shift, and it needs no window at all.  Acc has to hold the largest value of T
+   * shifted left by SHIFT.  SHIFT alone sets how smooth it is, the window the other filters
+   * are constructed with is taken and ignored, so that any of them fits the same place
+   */
+  template <typename T, unsigned char SHIFT, typename Acc = long>
+  class ExponentialMovingAverage {
+    public:
+      /**
+       * Constructor
+       * The average starts out at defaultVal.  size is ignored
+       */
+      ExponentialMovingAverage(T defaultVal = T(), unsigned char /*size*/ = 0): state((Acc)defaultVal << SHIFT) {}
+
+      /**
+       * Moves the average 1 / 2^SHIFT of the way towards newValue
+       * Returns the new average
+       */
+      T add(T newValue) {
+        state = state - (state >> SHIFT) + newValue;
+        return get();
+      }
+
+      /**
+       * Current average
+       */
+      T get() const {
+        return (T)(state >> SHIFT);
+      }
+
+    private:
+      Acc state;
+  };
+}
+#endif
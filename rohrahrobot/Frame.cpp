@@ -0,0 +1,117 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "Frame.h"
+using namespace rohrah;
+
+/**
+ * One step of CRC-8 with polynomial x^8 + x^2 + x + 1
+ */
+unsigned char rohrah::crc8(unsigned char crc, unsigned char data) {
+  crc ^= data;
+  for (unsigned char i = 0; i < 8; i++)
+    crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  return crc;
+}
+
+/**
+ * Build a frame around payload
+ */
+unsigned char rohrah::encodeFrame(unsigned char *out, unsigned char type, const unsigned char *payload, unsigned char length) {
+  unsigned char crc = crc8(crc8(0, type), length);
+  out[0] = FRAME_SYNC;
+  out[1] = type;
+  out[2] = length;
+  for (unsigned char i = 0; i < length; i++) {
+    out[3 + i] = payload[i];
+    crc = crc8(crc, payload[i]);
+  }
+  out[3 + length] = crc;
+  return length + FRAME_OVERHEAD;
+}
+
+/**
+ * Constructor
+ */
+FrameParser::FrameParser(): state(waitSync), type(0), length(0), received(0), crc(0), errors(0) {
+}
+
+/**
+ * Feed the next byte from the link
+ * Returns true when it completes a valid frame, which stays available until the next call
+ */
+bool FrameParser::parse(unsigned char b) {
+  switch (state) {
+    case waitSync:
+      if (b == FRAME_SYNC)
+        state = waitType;
+      break;
+    case waitType:
+      type = b;
+      crc = crc8(0, b);
+      state = waitLength;
+      break;
+    case waitLength:
+      if (b > FRAME_MAX_PAYLOAD) {
+        errors++;
+        state = waitSync;
+        break;
+      }
+      length = b;
+      received = 0;
+      crc = crc8(crc, b);
+      state = length > 0 ? waitPayload : waitCrc;
+      break;
+    case waitPayload:
+      payload[received++] = b;
+      crc = crc8(crc, b);
+      if (received >= length)
+        state = waitCrc;
+      break;
+    case waitCrc:
+      state = waitSync;
+      if (b == crc)
+        return true;
+      errors++;
+      break;
+  }
+  return false;
+}
+
+/**
+ * Drop the frame being received, if there is one, and count it as an error
+ */
+void FrameParser::abandon() {
+  if (state != waitSync)
+    errors++;
+  state = waitSync;
+}
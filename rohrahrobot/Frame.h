@@ -0,0 +1,126 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _FRAME_H_
+#define _FRAME_H_
+
+namespace rohrah {
+
+  /**
+   * Framed binary protocol on the Bluetooth link, next to the single character commands.
+   *
+   * A frame is FRAME_SYNC, type, payload length, payload, CRC-8 (polynomial 0x07) of
+   * type, length and payload.  FRAME_SYNC is not a printable character, so frames and
+   * legacy commands can be mixed on the same link.  Multi-byte values are little endian.
+   */
+  #define FRAME_SYNC 0xA5
+  #define FRAME_MAX_PAYLOAD 32
+  #define FRAME_OVERHEAD 4
+  #define FRAME_TIMEOUT 100 //ms without a byte after which a frame that stopped part way is dropped
+
+  // frame types sent to the robot
+  #define FRAME_DRIVE 0x01 //mode (RemoteControlCommand's controlCommand, autoCommand or moveCommand), left speed, right speed (int16)
+  #define FRAME_TELEMETRY 0x02 //telemetry period in ms (uint16), 0 switches it off
+  #define FRAME_SCRIPT 0x03 //offset (uint8) and the bytes of a motion script that go there, see MotionScript.h
+  #define FRAME_PING 0x04 //up to FRAME_MAX_PING bytes, sent straight back in a FRAME_ECHO
+  #define FRAME_PONG 0x05 //the payload of a FRAME_PROBE, sent back
+  #define FRAME_WATCHDOG 0x06 //ms (uint16) without a frame before the robot stops under remote control, 0 switches it off
+
+  // frame types sent by the robot
+  #define FRAME_TELEMETRY_KEY 0x81 //a complete telemetry sample, see Telemetry.h
+  #define FRAME_TELEMETRY_DELTA 0x82 //the changes since the previous telemetry sample
+  #define FRAME_TRACE 0x83 //records of the input trace, see Trace.h
+  #define FRAME_POSE 0x84 //x, y in cm (int16) and heading as a binary angle (uint16), see Odometry.h
+  #define FRAME_ECHO 0x85 //the payload of a FRAME_PING
+  #define FRAME_PROBE 0x86 //sequence number (uint8) and micros() (uint32), for the remote to send back in FRAME_PONG, see LinkMonitor.h
+
+  #define FRAME_MAX_PING 8
+
+  unsigned char crc8(unsigned char crc, unsigned char data);
+
+  /**
+   * Write a frame into out, which needs room for length + FRAME_OVERHEAD bytes.
+   * Returns the size of the frame
+   */
+  unsigned char encodeFrame(unsigned char *out, unsigned char type, const unsigned char *payload, unsigned char length);
+
+  /**
+   * Byte at a time frame decoder.  Bytes outside of a frame are ignored, as are frames
+   * that are too long or fail the CRC.  The caller drops a frame that stops coming in part
+   * way with abandon(), so that a stray FRAME_SYNC does not swallow what follows
+   */
+  class FrameParser {
+    public:
+      FrameParser();
+      bool parse(unsigned char b);
+      void abandon();
+      bool isIdle() const { return state == waitSync; }
+      unsigned char getType() const { return type; }
+      unsigned char getLength() const { return length; }
+      const unsigned char *getPayload() const { return payload; }
+      unsigned int getErrors() const { return errors; }
+
+    private:
+      enum state_t {waitSync, waitType, waitLength, waitPayload, waitCrc};
+      state_t state;
+      unsigned char type;
+      unsigned char length;
+      unsigned char received;
+      unsigned char crc;
+      unsigned int errors;
+      unsigned char payload[FRAME_MAX_PAYLOAD];
+  };
+
+  inline int readInt16(const unsigned char *p) {
+    return (int)(short)(p[0] | (p[1] << 8));
+  }
+
+  inline unsigned int readUint16(const unsigned char *p) {
+    return p[0] | ((unsigned int)p[1] << 8);
+  }
+
+  inline void writeInt16(unsigned char *p, int value) {
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+  }
+
+  inline unsigned long readUint32(const unsigned char *p) {
+    return readUint16(p) | ((unsigned long)readUint16(p + 2) << 16);
+  }
+
+  inline void writeUint32(unsigned char *p, unsigned long value) {
+    writeInt16(p, value & 0xFFFF);
+    writeInt16(p + 2, (value >> 16) & 0xFFFF);
+  }
+}
+
+#endif
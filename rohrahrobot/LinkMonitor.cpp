@@ -0,0 +1,156 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "LinkMonitor.h"
+#include "Frame.h"
+#include "LinkQueue.h"
+using namespace rohrah;
+
+#define FIRST_BUCKET 8 //ms, the top of the first bucket, each one after is twice as wide
+
+/**
+ * Constructor.  Quiet until the remote pings
+ */
+LinkMonitor::LinkMonitor(unsigned int timeout, unsigned int probeInterval): timeout(timeout), probeInterval(probeInterval),
+                                                                          armed(false), frames(0), lastFrame(0), lastProbe(0),
+                                                                          sequence(0), trips(0) {
+  reset();
+}
+
+/**
+ * Once per control pass, after the remote control has read the link: note when the last
+ * frame came, time the probe that came back, if one did, and send the next when it is due
+ */
+void LinkMonitor::update(RemoteControl &remote, Print &out, unsigned long currentTime) {
+  if (remote.getFrames() != frames) {
+    frames = remote.getFrames();
+    lastFrame = currentTime;
+  }
+  unsigned char number;
+  unsigned long sent, received;
+  if (remote.takeProbe(number, sent, received)) {
+    add(received - sent);
+  }
+  armed = remote.isPinged();
+  if (armed && currentTime - lastProbe >= probeInterval) {
+    lastProbe = currentTime;
+    unsigned char payload[5];
+    unsigned char frame[sizeof(payload) + FRAME_OVERHEAD];
+    payload[0] = ++sequence;
+    LinkQueue::finish(out); //not queued, the time in it has to be when it goes out
+    writeUint32(payload + 1, micros());
+    out.write(frame, encodeFrame(frame, FRAME_PROBE, payload, sizeof(payload)));
+    if (probes != 0xFFFF)
+      probes++;
+  }
+}
+
+/**
+ * True if the watchdog is on and no frame has come for its timeout
+ */
+bool LinkMonitor::isLost(unsigned long currentTime) const {
+  return armed && timeout != 0 && currentTime - lastFrame >= timeout;
+}
+
+/**
+ * Count a stop of the robot by the watchdog
+ */
+void LinkMonitor::trip() {
+  if (trips != 0xFFFF)
+    trips++;
+}
+
+/**
+ * Forget the round trips so far
+ */
+void LinkMonitor::reset() {
+  probes = 0;
+  answered = 0;
+  sum = 0;
+  minTrip = 0xFFFFFFFFUL;
+  maxTrip = 0;
+  for (unsigned char i = 0; i < NUM_BUCKETS; i++)
+    buckets[i] = 0;
+}
+
+/**
+ * Count a round trip in us
+ */
+void LinkMonitor::add(unsigned long roundTrip) {
+  unsigned char bucket = 0;
+  for (unsigned long top = FIRST_BUCKET * 1000UL; roundTrip >= top && bucket < NUM_BUCKETS - 1; top <<= 1)
+    bucket++;
+  if (buckets[bucket] != 0xFFFF)
+    buckets[bucket]++;
+  if (answered != 0xFFFF)
+    answered++;
+  sum += roundTrip;
+  if (roundTrip < minTrip)
+    minTrip = roundTrip;
+  if (roundTrip > maxTrip)
+    maxTrip = roundTrip;
+}
+
+/**
+ * Print the probes since the last report, how many did not come back, the mean, least
+ * and most round trip in ms, the histogram by the top of each bucket in ms, and the
+ * watchdog's timeout and how often it stopped the robot.  Then start over
+ */
+void LinkMonitor::report(Print &out) {
+  out.println(F("link probes lost mean min max"));
+  out.print(probes);
+  out.print(' ');
+  out.print(probes > answered ? probes - answered : 0);
+  out.print(' ');
+  out.print(answered ? sum / answered / 1000 : 0);
+  out.print(' ');
+  out.print(answered ? minTrip / 1000 : 0);
+  out.print(' ');
+  out.println(maxTrip / 1000);
+  out.print(F("rtt"));
+  for (unsigned char i = 0; i < NUM_BUCKETS - 1; i++) {
+    out.print(F(" <"));
+    out.print(FIRST_BUCKET << i);
+  }
+  out.println(F(" more"));
+  for (unsigned char i = 0; i < NUM_BUCKETS; i++) {
+    out.print(' ');
+    out.print(buckets[i]);
+  }
+  out.println();
+  out.println(F("watchdog timeout trips"));
+  out.print(timeout);
+  out.print(' ');
+  out.println(trips);
+  reset();
+}
@@ -0,0 +1,105 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _LINK_MONITOR_H_
+#define _LINK_MONITOR_H_
+
+#include <Arduino.h>
+#include "RemoteControl.h"
+
+namespace rohrah {
+
+  /**
+   * Watches the remote control link: how long a round trip takes, and whether the link
+   * is still there at all.
+   *
+   * A remote takes part by sending a FRAME_PING now and then, which the robot echoes at
+   * once, so the remote can time its own round trips.  From the first ping on, the robot
+   * sends a FRAME_PROBE every probeInterval and the remote sends it back as a FRAME_PONG.
+   * The round trip of each probe, which includes the wait for the next control pass, goes
+   * into a histogram of power of two buckets from 8ms up.
+   *
+   * The watchdog runs from the first ping on as well, so a remote that only sends
+   * commands, e.g. a Bluetooth terminal, is not cut off.  Under remote control a moving
+   * robot stops if no valid frame of any type came for timeout ms, and isLost() says when.
+   * FRAME_WATCHDOG changes the timeout, 0 switches it off.
+   *
+   * 'L' reports the round trips since the last report and how often the watchdog tripped.
+   */
+  class LinkMonitor {
+    public:
+      static const unsigned char NUM_BUCKETS = 8;
+
+      LinkMonitor(unsigned int timeout, unsigned int probeInterval);
+      void setTimeout(unsigned int ms) { timeout = ms; }
+      void update(RemoteControl &remote, Print &out, unsigned long currentTime);
+      bool isLost(unsigned long currentTime) const;
+      void trip();
+      void report(Print &out);
+
+    private:
+      void reset();
+      void add(unsigned long roundTrip);
+
+      unsigned int timeout; //ms, 0 for no watchdog
+      unsigned int probeInterval; //ms
+      bool armed; //the remote has pinged
+      unsigned char frames; //the remote control's count of them at the last update
+      unsigned long lastFrame; //ms
+      unsigned long lastProbe; //ms
+      unsigned char sequence; //of the last probe
+      unsigned int probes; //sent since the last report
+      unsigned int answered;
+      unsigned int buckets[NUM_BUCKETS];
+      unsigned long sum; //us
+      unsigned long minTrip; //us
+      unsigned long maxTrip; //us
+      unsigned int trips; //times the watchdog stopped the robot
+  };
+
+  /**
+   * Stands in for LinkMonitor in a robot built without it.  Pings are still echoed, but
+   * the robot neither probes nor stops when the link goes quiet
+   */
+  class NoLinkMonitor {
+    public:
+      NoLinkMonitor(unsigned int /*timeout*/, unsigned int /*probeInterval*/) {}
+      void setTimeout(unsigned int /*ms*/) {}
+      void update(RemoteControl &/*remote*/, Print &/*out*/, unsigned long /*currentTime*/) {}
+      bool isLost(unsigned long /*currentTime*/) const { return false; }
+      void trip() {}
+      void report(Print &out) { out.println(F("link monitor not built in")); }
+  };
+}
+
+#endif
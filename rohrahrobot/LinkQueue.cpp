@@ -0,0 +1,85 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "LinkQueue.h"
+#include "Frame.h"
+#include "RingBuffer.h"
+#include "McuLocal.h"
+
+using namespace rohrah;
+
+//the trace needs room for a few of its frames next to the telemetry
+#ifdef TRACING
+#define QUEUE_SIZE 256
+#else
+#define QUEUE_SIZE 64
+#endif
+
+static MCU_LOCAL RingBuffer<QUEUE_SIZE> frames;
+static MCU_LOCAL unsigned char inFlight = 0; //bytes of the frame drain() is part way through
+
+/**
+ * Queue a frame of size bytes, all of it or, if there is not room for all of it, none.
+ * Returns false if it did not fit
+ */
+bool LinkQueue::put(const unsigned char *frame, unsigned char size) {
+  if (frames.space() < size)
+    return false;
+  for (unsigned char i = 0; i < size; i++)
+    frames.put(frame[i]);
+  return true;
+}
+
+/**
+ * Move up to maxBytes of queued frames to out, but only as many as it takes without blocking
+ */
+void LinkQueue::drain(Print &out, unsigned char maxBytes) {
+  int room = out.availableForWrite();
+  while (maxBytes-- > 0 && room-- > 0 && !frames.isEmpty()) {
+    if (inFlight == 0) //the start of a frame, which is queued whole
+      inFlight = frames.peek(2) + FRAME_OVERHEAD;
+    out.write((unsigned char)frames.get());
+    inFlight--;
+  }
+}
+
+/**
+ * Write out the rest of the frame drain() is part way through, if any, however long the
+ * link takes, so that what is written to out next does not land in the middle of it
+ */
+void LinkQueue::finish(Print &out) {
+  while (inFlight > 0) {
+    out.write((unsigned char)frames.get());
+    inFlight--;
+  }
+}
@@ -0,0 +1,60 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _LINK_QUEUE_H_
+#define _LINK_QUEUE_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Frames waiting for the Bluetooth link.
+   * Telemetry, the trace and the pose queue whole frames here, and drain() moves them out a
+   * few bytes at a time so that none of them stalls the loop.  With one queue for all of
+   * them, frames go out whole, one after the other, never mixed byte by byte.
+   *
+   * Whatever is written to the link straight away (echoes, probes, reports) calls finish()
+   * first, which writes out the rest of the frame drain() is part way through.
+   *
+   * These are static methods. No need to instantiate an object of the LinkQueue class
+   */
+  class LinkQueue {
+    public:
+      static bool put(const unsigned char *frame, unsigned char size);
+      static void drain(Print &out, unsigned char maxBytes = 8);
+      static void finish(Print &out);
+  };
+}
+
+#endif
@@ -32,27 +32,86 @@
 
 #include <Arduino.h> //for definition of Serial
 #include "Logger.h"
-#include <stdarg.h>
+#include "RingBuffer.h"
+#include "McuLocal.h"
 
 using namespace rohrah;
 
-#define BUFFER_SIZE 1024
+#define BUFFER_SIZE 64
+#define MAX_VARINT_SIZE 5
 
 /**
  * If LOGGING is defined, log to the Serial port.  Otherwise do nothing
- * This is a static method. No need to instantiate an object of the Logger class
+ * These are static methods. No need to instantiate an object of the Logger class
  */
 
 #ifdef LOGGING
-void Logger::log(char *format, ...) {
-  char buffer[BUFFER_SIZE];
-  va_list args;
-  va_start (args, format);
-  vsnprintf(buffer, sizeof(buffer), format, args);
-  va_end (args); 
-  Serial.print(buffer);
+static MCU_LOCAL RingBuffer<BUFFER_SIZE> records;
+static MCU_LOCAL unsigned long lastRecordTime = 0;
+static MCU_LOCAL unsigned int droppedRecords = 0;
+
+static void putVarint(unsigned long value) {
+  while (value >= 0x80) {
+    records.put((unsigned char)(value | 0x80));
+    value >>= 7;
+  }
+  records.put((unsigned char)value);
+}
+
+static void putHeader(Logger::message_t id, unsigned char argCount, unsigned long now) {
+  records.put(Logger::LOG_SYNC);
+  records.put(id);
+  records.put(argCount);
+  putVarint(now - lastRecordTime);
+  lastRecordTime = now;
+}
+
+/**
+ * Start a record.  A record that might not fit is dropped whole, and counted
+ * so that a logDropped record can say so once there is room again
+ */
+bool Logger::begin(message_t id, unsigned char argCount) {
+  unsigned char needed = 3 + MAX_VARINT_SIZE * (argCount + 1);
+  if (droppedRecords > 0)
+    needed += 3 + MAX_VARINT_SIZE * 2;
+  if (records.space() < needed) {
+    droppedRecords++;
+    return false;
+  }
+  unsigned long now = millis();
+  if (droppedRecords > 0) {
+    putHeader(logDropped, 1, now);
+    put(droppedRecords);
+    droppedRecords = 0;
+  }
+  putHeader(id, argCount, now);
+  return true;
+}
+
+/**
+ * Append one zigzag encoded argument to the current record
+ */
+void Logger::put(long value) {
+  putVarint(((unsigned long)value << 1) ^ (value < 0 ? ~0UL : 0UL));
+}
+
+/**
+ * Move up to maxBytes of buffered records to the Serial port, but only as many
+ * as fit in its transmit buffer right now
+ */
+void Logger::drain(unsigned char maxBytes) {
+  int room = Serial.availableForWrite();
+  while (maxBytes-- > 0 && room-- > 0 && !records.isEmpty())
+    Serial.write((unsigned char)records.get());
 }
 #else 
-void Logger::log(char *format, ...) {
+bool Logger::begin(message_t /*id*/, unsigned char /*argCount*/) {
+  return false;
+}
+
+void Logger::put(long /*value*/) {
+}
+
+void Logger::drain(unsigned char /*maxBytes*/) {
 }
-#endif
+#endif
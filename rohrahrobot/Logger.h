@@ -33,11 +33,54 @@
 #ifndef _LOGGER_H_
 #define _LOGGER_H_
 
+#include "Transport.h" //for BT_HARDWARE_UART
+#include "LogMessages.h"
+
+// The binary log on Serial.  Define NO_LOGGING to build without it.  With the Bluetooth
+// module on the hardware UART Serial is the link, and the records would get mixed up with
+// the frames, so there is no log then either
+#if !defined(NO_LOGGING) && !defined(BT_HARDWARE_UART)
+#define LOGGING
+#endif
+
 namespace rohrah {
+
+  /**
+   * Deferred binary logger.
+   * log() appends a record (message id, time stamp and the raw integer arguments) to a
+   * small ring buffer, and drain() moves a few bytes of it to the Serial port without
+   * ever blocking.  If LOGGING is not defined every call does nothing.
+   *
+   * Record layout: LOG_SYNC, id, argument count, millis() since the previous record,
+   * then the arguments.  Numbers are varints, arguments zigzag encoded.
+   */
   class Logger {
     public:
-      static void log(char* format, ...);
+      #define LOG_MESSAGE_ID(id, format) id,
+      enum message_t { LOG_MESSAGES(LOG_MESSAGE_ID) numMessages };
+      #undef LOG_MESSAGE_ID
+
+      static const unsigned char LOG_SYNC = 0xAA;
+
+      template <typename... Args>
+      static void log(message_t id, Args... args) {
+        if (begin(id, sizeof...(args)))
+          putArgs(args...);
+      }
+
+      static void drain(unsigned char maxBytes = 8);
+
+    private:
+      static bool begin(message_t id, unsigned char argCount);
+      static void put(long value);
+
+      static void putArgs() {}
+      template <typename... Rest>
+      static void putArgs(long first, Rest... rest) {
+        put(first);
+        putArgs(rest...);
+      }
   };
 }
 
-#endif
+#endif
@@ -0,0 +1,104 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _MEDIAN_FILTER_H_
+#define _MEDIAN_FILTER_H_
+
+namespace rohrah {
+
+  /**
+   * Median of the last N values.  Unlike an average a single wild reading, such as a
+   * missed echo, does not move the output at all.  Keeps the window both in arrival
+   * order and sorted, so add() costs one pass over the window and no division.
+   * Like MovingAverage's, the window can be shorter than N, picked at run time.
+   * An odd window gives a true median, an even one the upper of the two middle values
+   */
+  template <typename T, unsigned char N>
+  class MedianFilter {
+    public:
+      /**
+       * Constructor
+       * Defines a window of size values, all initialized to defaultVal.
+       * Sizes of 0 or over N mean N
+       */
+      MedianFilter(T defaultVal = T(), unsigned char size = N): index(0), size(size == 0 || size > N ? N : size) {
+        for (unsigned char i = 0; i < this->size; i++) {
+          buffer[i] = defaultVal;
+          sorted[i] = defaultVal;
+        }
+      }
+
+      /**
+       * Replaces the oldest value in the window with newValue
+       * Returns the new median
+       */
+      T add(T newValue) {
+        T oldest = buffer[index];
+        buffer[index++] = newValue;
+        if (index >= size) {
+          index = 0;
+        }
+
+        //find the oldest value in the sorted window...
+        unsigned char pos = 0;
+        while (sorted[pos] != oldest)
+          pos++;
+        //...and slide newValue from there to where it belongs
+        while (pos > 0 && sorted[pos - 1] > newValue) {
+          sorted[pos] = sorted[pos - 1];
+          pos--;
+        }
+        while (pos < size - 1 && sorted[pos + 1] < newValue) {
+          sorted[pos] = sorted[pos + 1];
+          pos++;
+        }
+        sorted[pos] = newValue;
+        return get();
+      }
+
+      /**
+       * Current median
+       */
+      T get() const {
+        return sorted[size / 2];
+      }
+
+      unsigned char getSize() const { return size; }
+
+    private:
+      T buffer[N];
+      T sorted[N];
+      unsigned char index;
+      unsigned char size;
+  };
+}
+#endif
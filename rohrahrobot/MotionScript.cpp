@@ -0,0 +1,227 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "MotionScript.h"
+#include "Frame.h"
+using namespace rohrah;
+
+#define MAX_SPEED 255
+
+/**
+ * Constructor.  Nothing to run until start()
+ */
+MotionScript::MotionScript(): result(resultIdle), pc(0), depth(0), waiting(false), due(0), leftSpeed(0), rightSpeed(0), segments(0), lateSum(0), maxLate(0) {
+}
+
+/**
+ * Bytes in the instruction with opcode op, 0 for an unknown opcode
+ */
+unsigned char MotionScript::size(unsigned char op) {
+  switch (op) {
+    case opEnd:
+    case opNext:
+      return 1;
+    case opRepeat:
+      return 2;
+    case opUntilCloser:
+    case opUntilFarther:
+      return 5;
+    case opDrive:
+      return 7;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * Check the first length bytes of code for a script that can run.
+ * Returns its length up to and including opEnd, or -1 if it is not one
+ */
+int MotionScript::check(const unsigned char *code, unsigned char length) {
+  unsigned char nesting = 0;
+  unsigned char at = 0;
+  while (at < length) {
+    unsigned char op = code[at];
+    unsigned char bytes = size(op);
+    if (bytes == 0 || bytes > length - at)
+      return -1;
+    if (op == opRepeat && ++nesting > MAX_DEPTH)
+      return -1;
+    if (op == opNext && nesting-- == 0)
+      return -1;
+    if (op == opEnd)
+      return nesting == 0 ? at + 1 : -1;
+    at += bytes;
+  }
+  return -1;
+}
+
+/**
+ * Start the script in code from the top, if it checks out.  The robot stands still
+ * until the first drive segment
+ */
+bool MotionScript::start(const unsigned char *code, unsigned char length, unsigned long currentMicros) {
+  if (check(code, length) < 0) {
+    result = resultInvalid;
+    return false;
+  }
+  result = resultRunning;
+  pc = 0;
+  depth = 0;
+  waiting = false;
+  due = currentMicros;
+  leftSpeed = rightSpeed = 0;
+  segments = 0;
+  lateSum = 0;
+  maxLate = 0;
+  return true;
+}
+
+/**
+ * Cut the script short
+ */
+void MotionScript::stop() {
+  if (result == resultRunning)
+    result = resultIdle;
+  leftSpeed = rightSpeed = 0;
+}
+
+/**
+ * Run the instructions that are due, and return the speeds the motors should be at in
+ * left and right.  Returns resultRunning until the script is over, and the speeds are 0
+ * from then on
+ */
+MotionScript::result_t MotionScript::step(const unsigned char *code, unsigned long currentMicros, unsigned int distance, int &left, int &right) {
+  for (unsigned char n = 0; n < MAX_STEPS && result == resultRunning; n++) {
+    const unsigned char *p = code + pc;
+    if (waiting) {
+      if (!waitOver(code, currentMicros, distance))
+        break;
+      waiting = false;
+      pc += size(*p);
+      continue;
+    }
+    if ((long)(currentMicros - due) < 0)
+      break;
+    switch (*p) {
+      case opEnd:
+        result = resultDone;
+        leftSpeed = rightSpeed = 0;
+        track(currentMicros);
+        break;
+      case opDrive:
+        leftSpeed = constrain(readInt16(p + 1), -MAX_SPEED, MAX_SPEED);
+        rightSpeed = constrain(readInt16(p + 3), -MAX_SPEED, MAX_SPEED);
+        track(currentMicros);
+        due += readUint16(p + 5) * 1000UL;
+        pc += size(opDrive);
+        break;
+      case opRepeat:
+        loops[depth].start = pc + size(opRepeat);
+        loops[depth].count = p[1];
+        depth++;
+        pc = loops[depth - 1].start;
+        break;
+      case opNext: {
+        Loop &loop = loops[depth - 1];
+        if (loop.count == 0 || --loop.count > 0) {
+          pc = loop.start;
+        }
+        else {
+          depth--;
+          pc += size(opNext);
+        }
+        break;
+      }
+      default: //opUntilCloser, opUntilFarther
+        waiting = true;
+        due += readUint16(p + 3) * 1000UL;
+        break;
+    }
+  }
+  left = leftSpeed;
+  right = rightSpeed;
+  return result;
+}
+
+/**
+ * Count a change of speeds, a drive segment or the stop at the end, and how late it came
+ */
+void MotionScript::track(unsigned long currentMicros) {
+  unsigned long late = currentMicros - due;
+  segments++;
+  lateSum += late;
+  if (late > maxLate)
+    maxLate = late > 0xFFFF ? 0xFFFF : late;
+}
+
+/**
+ * True once the wait at pc is over.  If the centre sensor says so, the next instruction
+ * is due now, otherwise when the wait timed out
+ */
+bool MotionScript::waitOver(const unsigned char *code, unsigned long currentMicros, unsigned int distance) {
+  const unsigned char *p = code + pc;
+  unsigned int cm = readUint16(p + 1);
+  if (*p == opUntilCloser ? distance <= cm : distance > cm) {
+    due = currentMicros;
+    return true;
+  }
+  return (long)(currentMicros - due) >= 0;
+}
+
+/**
+ * Print how the last script went: how far it got, the changes of speed it made, drive
+ * segments and the stop at the end, and how late they came on average and at worst, in us
+ */
+void MotionScript::report(Print &out) {
+  out.println(F("script segments late max"));
+  switch (result) {
+    case resultRunning:
+      out.print(F("running "));
+      break;
+    case resultDone:
+      out.print(F("done "));
+      break;
+    case resultInvalid:
+      out.println(F("invalid"));
+      return;
+    default:
+      out.print(F("stopped "));
+      break;
+  }
+  out.print(segments);
+  out.print(' ');
+  out.print(segments ? lateSum / segments : 0);
+  out.print(' ');
+  out.println(maxLate);
+}
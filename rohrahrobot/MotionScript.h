@@ -0,0 +1,158 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _MOTION_SCRIPT_H_
+#define _MOTION_SCRIPT_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Interpreter of motion scripts, small programs the robot runs on its own, so that a
+   * manoeuvre costs no Bluetooth round trip per step and does not wait on the link's
+   * jitter.  The code lives in a MotionProgram, and is assembled on the host by motionasm.
+   *
+   * An instruction is an opcode byte and its operands, multi-byte ones little endian:
+   *   opEnd                          stop, the script is over
+   *   opDrive left right ms          set the speeds (int16, -255 to 255) and keep them for ms (uint16)
+   *   opRepeat count                 run up to the matching opNext count times (uint8), 0 for ever
+   *   opNext                         end of the loop
+   *   opUntilCloser cm timeout       keep the speeds until the centre sensor has something
+   *                                  within cm (uint16), for timeout ms (uint16) at most
+   *   opUntilFarther cm timeout      the same, until it has nothing within cm
+   * Loops nest up to MAX_DEPTH deep.  A script is checked before it starts: known opcodes,
+   * whole instructions, balanced loops and opEnd last.
+   *
+   * Segments are timed from deadline to deadline in us, not from whenever a step happened
+   * to run, so lateness does not add up over a script.  How late each drive segment
+   * started, and the stop at the end, is kept for a report, to see how precisely the
+   * script ran.
+   */
+  class MotionScript {
+    public:
+      enum op_t {opEnd, opDrive, opRepeat, opNext, opUntilCloser, opUntilFarther, numOps};
+      enum result_t {resultIdle, resultRunning, resultDone, resultInvalid};
+      static const unsigned char MAX_DEPTH = 4;
+      static const unsigned char MAX_STEPS = 8; //instructions per step(), a loop that takes no time cannot hang the robot
+
+      MotionScript();
+      static unsigned char size(unsigned char op);
+      static int check(const unsigned char *code, unsigned char length);
+      bool start(const unsigned char *code, unsigned char length, unsigned long currentMicros);
+      void stop();
+      result_t step(const unsigned char *code, unsigned long currentMicros, unsigned int distance, int &left, int &right);
+      result_t getResult() const { return result; }
+      void report(Print &out);
+
+    private:
+      struct Loop {
+        unsigned char start; //first instruction of the body
+        unsigned char count; //runs left, 0 for ever
+      };
+
+      void track(unsigned long currentMicros);
+      bool waitOver(const unsigned char *code, unsigned long currentMicros, unsigned int distance);
+
+      result_t result;
+      unsigned char pc;
+      unsigned char depth;
+      Loop loops[MAX_DEPTH];
+      bool waiting;
+      unsigned long due; //us, when the instruction at pc is due, or a wait times out
+      int leftSpeed;
+      int rightSpeed;
+      unsigned int segments; //drive segments started and the stop at the end
+      unsigned long lateSum; //us
+      unsigned int maxLate; //us
+  };
+
+  /**
+   * A motion script of up to SIZE bytes and the interpreter running it.  The script is
+   * uploaded in chunks, each an offset and the bytes that go there.  Offset 0 starts a new
+   * script and the chunks have to follow on from each other, so a lost one shows as a
+   * script that does not check out
+   */
+  template<unsigned char SIZE>
+  class MotionProgram {
+    public:
+      MotionProgram(): length(0) {}
+
+      /**
+       * Add a chunk: the offset, then the bytes.  False if it does not follow on or fit,
+       * or a script is running
+       */
+      bool load(const unsigned char *chunk, unsigned char chunkLength) {
+        if (chunkLength < 1 || script.getResult() == MotionScript::resultRunning)
+          return false;
+        unsigned char offset = chunk[0];
+        if (offset == 0)
+          length = 0;
+        if (offset != length || chunkLength - 1 > SIZE - length)
+          return false;
+        memcpy(code + length, chunk + 1, chunkLength - 1);
+        length += chunkLength - 1;
+        return true;
+      }
+
+      bool start(unsigned long currentMicros) { return script.start(code, length, currentMicros); }
+      void stop() { script.stop(); }
+      MotionScript::result_t step(unsigned long currentMicros, unsigned int distance, int &left, int &right) {
+        return script.step(code, currentMicros, distance, left, right);
+      }
+      void report(Print &out) { script.report(out); }
+
+    private:
+      unsigned char code[SIZE];
+      unsigned char length;
+      MotionScript script;
+  };
+
+  /**
+   * Stands in for MotionProgram in a robot built without motion scripts.  Uploads are
+   * dropped and a script never starts
+   */
+  class NoMotionProgram {
+    public:
+      bool load(const unsigned char * /*chunk*/, unsigned char /*chunkLength*/) { return false; }
+      bool start(unsigned long /*currentMicros*/) { return false; }
+      void stop() {}
+      MotionScript::result_t step(unsigned long /*currentMicros*/, unsigned int /*distance*/, int &left, int &right) {
+        left = right = 0;
+        return MotionScript::resultDone;
+      }
+      void report(Print &out) { out.println(F("scripts not built in")); }
+  };
+}
+
+#endif
@@ -30,6 +30,7 @@
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 
+#include <EEPROM.h>
 #include "Motor.h"
 using namespace rohrah;
 
@@ -38,7 +39,8 @@ using namespace rohrah;
  * Initializes the motor member variable with the number and sets the current speed to zero
  * Uses the Adafruit motor shield and associated library 
  */
-Motor::Motor(int number): motor(number), currentSpeed(0) {
+Motor::Motor(int number): motor(number), currentSpeed(0), outputSpeed(0), driven(0), rampRate(0), table(NO_TABLE), lastUpdate(0),
+                          closedLoop(false) {
 }
 
 /**
@@ -53,28 +55,115 @@ Motor::~Motor() {
  * Positive values signifies forward direction
  * Negative values signifies backward direction
  * Zero means stop
+ * With a ramp rate set this is only the target, update() gets the motor there
  */
 void Motor::setSpeed(int speed) {
-    currentSpeed = speed;
+    currentSpeed = constrain(speed, -255, 255);
+    if (rampRate == 0)
+      apply(currentSpeed);
+}
+
+/**
+ * Limit how fast the output may change, in counts per millisecond.
+ * Zero switches ramping off and applies the target right away
+ */
+void Motor::setRampRate(unsigned char countsPerMs) {
+    rampRate = countsPerMs;
+    if (rampRate == 0)
+      apply(currentSpeed);
+}
+
+/**
+ * Map speeds to PWM through the 256 byte table at address in EEPROM, one read per change
+ * of speed (see MotorCalibration).  NO_TABLE drives the motor with the speed as its PWM
+ */
+void Motor::setTable(int address) {
+    noInterrupts();
+    table = address;
+    int speed = driven;
+    driven = 0;
+    motor.setSpeed(0);
+    drive(speed);
+    interrupts();
+}
+
+/**
+ * Switch closed loop on or off.  Off, the shield goes straight to the output
+ */
+void Motor::setClosedLoop(bool on) {
+    noInterrupts();
+    closedLoop = on;
+    interrupts();
+    if (!on)
+      drive(outputSpeed);
+}
+
+/**
+ * Move the output toward the target by at most rampRate counts for every millisecond
+ * since the last step.  A reversal stops at zero first, so the motor never goes from
+ * one direction straight into the other.  Cheap enough to call on every loop
+ */
+void Motor::update(unsigned long currentTime) {
+    if (rampRate == 0 || outputSpeed == currentSpeed) {
+      lastUpdate = currentTime;
+      return;
+    }
+    unsigned long elapsed = currentTime - lastUpdate;
+    if (elapsed == 0)
+      return;
+    lastUpdate = currentTime;
+    long step = (long)(elapsed < 510 ? elapsed : 510) * rampRate; //510 is a full swing, and no overflow
+    //head for zero first when the direction changes
+    int target = ((outputSpeed > 0 && currentSpeed < 0) || (outputSpeed < 0 && currentSpeed > 0)) ? 0 : currentSpeed;
+    if (target > outputSpeed)
+      apply(outputSpeed + step < target ? outputSpeed + step : target);
+    else
+      apply(outputSpeed - step > target ? outputSpeed - step : target);
+}
+
+/**
+ * Make speed the output.  Open loop that drives the shield, closed loop the controller
+ * reads it in its interrupt, so it changes with interrupts off
+ */
+void Motor::apply(int speed) {
+    if (speed == outputSpeed)
+      return;
+    noInterrupts();
+    outputSpeed = speed;
+    interrupts();
+    if (!closedLoop)
+      drive(speed);
+}
+
+/**
+ * Drive the shield.  The PWM register is only written when the magnitude changes and
+ * the latch, a byte shifted out to the 74HC595, only when the direction does
+ */
+void Motor::drive(int speed) {
+    if (speed == driven)
+      return;
+    int previous = driven;
+    driven = speed;
+    if (abs(speed) != abs(previous))
+      motor.setSpeed(table == NO_TABLE ? abs(speed) : EEPROM.read(table + abs(speed)));
     if(speed >0) { //forward
-      motor.setSpeed(speed);
-      motor.run(FORWARD);
+      if (previous <= 0)
+        motor.run(FORWARD);
     }
     else if (speed <0) { //backward
-      motor.setSpeed(-speed);
-      motor.run(BACKWARD);
+      if (previous >= 0)
+        motor.run(BACKWARD);
     }
     else { //stop
-      motor.setSpeed(0);
       motor.run(RELEASE);
     }
 }
 
 /**
- * Get the current motor speed
+ * Get the current motor speed, the target when ramping
  */
 int Motor::getSpeed() const {
     return currentSpeed;
 }
   
-
+
@@ -47,12 +47,36 @@ namespace rohrah {
        */
       void setSpeed(int speed);
       int getSpeed() const;
+      int getOutput() const { return outputSpeed; }
+      void setRampRate(unsigned char countsPerMs);
+      void setTable(int address);
+      void update(unsigned long currentTime);
+
+      /**
+       * Closed loop.  The output, the speed after ramping, is only the setpoint of a speed
+       * controller (see WheelSpeedControl), which drives the shield with drive() from its
+       * interrupt.  Open loop the output goes to the shield as it is
+       */
+      void setClosedLoop(bool on);
+      bool isClosedLoop() const { return closedLoop; }
+      void drive(int speed);
+      int getDriven() const { return driven; }
+
+      static const int NO_TABLE = -1;
       
     private:
+      void apply(int speed);
+
       AF_DCMotor motor;
-      int currentSpeed;
+      int currentSpeed; //the speed asked for
+      int outputSpeed; //the speed ramped to so far
+      int driven; //the speed the shield is driving, the output unless in closed loop
+      unsigned char rampRate; //counts per ms, zero applies speeds immediately
+      int table; //EEPROM address of the speed to PWM table, or NO_TABLE to use speeds as PWM
+      unsigned long lastUpdate;
+      volatile bool closedLoop;
     
   };
 }
 
-#endif
+#endif
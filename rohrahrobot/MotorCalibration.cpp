@@ -0,0 +1,397 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <EEPROM.h>
+#include "MotorCalibration.h"
+#include "Frame.h"
+#include "Trig.h"
+
+using namespace rohrah;
+
+#define CALIBRATION_MAGIC 0x4D //'M'
+#define CALIBRATION_VERSION 1
+#define APPROACH_SPEED 200 //PWM, with room either side to steer square to the wall
+#define APPROACH_STEER 3 //PWM either way per degree off square
+#define APPROACH_DISTANCE 70 //cm from the wall the steps start at
+#define APPROACH_TIMEOUT 10000 //ms to find a wall in
+#define ALIGN_SPEED 110 //PWM to spin at when not square to the wall at the end of the approach
+#define ALIGN_TOLERANCE 910 //binary angle, 5 degrees
+#define ALIGN_TIMEOUT 5000 //ms to square up to the wall in
+#define DISTANCE_TOLERANCE 5 //cm either side of APPROACH_DISTANCE a step can start at
+#define MIN_WALL_DISTANCE 12 //cm, closer than this and the steps stop
+#define SETTLE_TIME 200 //ms for the motors to ramp before a window starts counting
+#define WINDOW_TIME 400 //ms of samples per direction and step, short enough for a wheel in its deadband not to swing the robot far
+#define MIN_SAMPLES 3
+#define MOVING_SPEED 16 //Q12.4 cm/s, slower than this counts as standing still
+#define MIN_TOP_SPEED 80 //Q12.4 cm/s the slower wheel has to reach at full PWM
+#define SIDE_RATIO 28378L //1 / tan 30 degrees in Q1.14, for side sensors 30 degrees off the heading
+#define SIDE_COS2 28378L //2 cos 30 degrees in Q1.14, the same number
+
+/**
+ * Constructor
+ * wheelBase is the distance between the wheels in cm
+ */
+MotorCalibration::MotorCalibration(unsigned char wheelBase, unsigned char sensorOffset):
+                                   wheelBase(wheelBase), sensorOffset(sensorOffset), phase(phaseIdle),
+                                   result(resultDone), step(0), phaseStart(0), windowStart(0), measuring(false),
+                                   angle(0), previousAngle(0), angleTime(0), previousAngleTime(0), haveAngle(false),
+                                   closing(0), closingTime(0), maxSpeed(0), saved(0), crc(0) {
+  for (unsigned char i = 0; i < numRays; i++) {
+    latest[i] = 0;
+    echo[i] = false;
+  }
+  for (unsigned char m = 0; m < numMotors; m++) {
+    edge[m] = 0;
+    for (unsigned char i = 0; i < NUM_STEPS; i++)
+      response[m][i] = 0;
+  }
+}
+
+/**
+ * Begin with the approach to the wall
+ */
+void MotorCalibration::start(unsigned long currentTime) {
+  for (unsigned char i = 0; i < numRays; i++)
+    echo[i] = false;
+  haveAngle = false;
+  step = 0;
+  result = resultRunning;
+  startPhase(phaseApproach, currentTime);
+}
+
+void MotorCalibration::startPhase(phase_t next, unsigned long currentTime) {
+  phase = next;
+  phaseStart = currentTime;
+  measuring = false;
+}
+
+/**
+ * Call on every control pass.  Sets the PWM each motor has to be driven with, raw,
+ * without any table, and returns resultRunning until calibration is over
+ */
+MotorCalibration::result_t MotorCalibration::update(unsigned long currentTime, int &left, int &right) {
+  left = 0;
+  right = 0;
+  unsigned long elapsed = currentTime - phaseStart;
+  switch (phase) {
+    case phaseApproach:
+      if (elapsed >= APPROACH_TIMEOUT)
+        return result = resultNoWall;
+      if (!echo[rayCenter] || latest[rayCenter] > APPROACH_DISTANCE) {
+        //steer square to the wall once the side sensors see it
+        int steer = haveAngle ? constrain(angle / (ALIGN_TOLERANCE / 5) * APPROACH_STEER, -55, 55) : 0;
+        left = APPROACH_SPEED + steer;
+        right = APPROACH_SPEED - steer;
+        return resultRunning;
+      }
+      startPhase(phaseAlign, currentTime);
+      return resultRunning;
+    case phaseAlign:
+      if (elapsed >= ALIGN_TIMEOUT)
+        return result = resultNoWall;
+      if (!haveAngle || abs(angle) > ALIGN_TOLERANCE) {
+        //spin square, clockwise if turned counter clockwise
+        left = haveAngle && angle < 0 ? -ALIGN_SPEED : ALIGN_SPEED;
+        right = -left;
+        return resultRunning;
+      }
+      if (!echo[rayCenter] || abs((int)latest[rayCenter] - APPROACH_DISTANCE) > DISTANCE_TOLERANCE) {
+        //and back to where the steps started, the backward half of a step does not quite undo the forward one
+        left = !echo[rayCenter] || latest[rayCenter] > APPROACH_DISTANCE ? ALIGN_SPEED : -ALIGN_SPEED;
+        right = left;
+        return resultRunning;
+      }
+      startPhase(phaseForward, currentTime);
+      break;
+    case phaseForward:
+    case phaseBackward:
+      if (elapsed >= SETTLE_TIME + WINDOW_TIME) {
+        result = finishWindow();
+        if (result != resultRunning)
+          return result;
+        if (phase == phaseForward) {
+          startPhase(phaseBackward, currentTime);
+        }
+        else if (++step < NUM_STEPS) {
+          //square up again, so that a step with one wheel in its deadband starts facing the wall
+          startPhase(phaseAlign, currentTime);
+          return resultRunning;
+        }
+        else {
+          result = finishSteps();
+          if (result != resultRunning)
+            return result;
+          startPhase(phaseSaving, currentTime);
+          saved = 0;
+          crc = 0;
+          EEPROM.update(ADDRESS, 0xFF); //no valid tables until they are all written
+          return resultRunning;
+        }
+      }
+      else if (!measuring && elapsed >= SETTLE_TIME) {
+        measuring = true;
+        windowStart = micros();
+        closing = 0;
+        closingTime = windowStart;
+        for (unsigned char i = 0; i < numFits; i++)
+          fits[i].n = fits[i].t = fits[i].v = fits[i].tt = fits[i].tv = 0;
+      }
+      else if (echo[rayCenter] && latest[rayCenter] < MIN_WALL_DISTANCE && phase == phaseForward) {
+        return result = resultNoWall;
+      }
+      break;
+    case phaseSaving:
+      for (unsigned char i = 0; i < SAVE_BYTES_PER_PASS && saved < 2 * 256U; i++, saved++) {
+        unsigned char pwm = pwmFor(saved >> 8, saved & 0xFF);
+        crc = crc8(crc, pwm);
+        EEPROM.update(TABLE_ADDRESS + saved, pwm);
+      }
+      if (saved < 2 * 256U)
+        return resultRunning;
+      EEPROM.update(ADDRESS + 1, CALIBRATION_VERSION);
+      EEPROM.update(ADDRESS + 2, maxSpeed & 0xFF);
+      EEPROM.update(ADDRESS + 3, maxSpeed >> 8);
+      EEPROM.update(ADDRESS + 4, crc);
+      EEPROM.update(ADDRESS, CALIBRATION_MAGIC);
+      phase = phaseIdle;
+      return result = resultDone;
+    default:
+      return result;
+  }
+  int pwm = stepPwm(step);
+  left = phase == phaseForward ? pwm : -pwm;
+  right = left;
+  return resultRunning;
+}
+
+/**
+ * A sample of one of the sensors, time in us.  A side sample updates the angle to the
+ * wall, a centre sample makes the distance of the middle of the robot from it
+ */
+void MotorCalibration::add(unsigned char ray, unsigned int cm, bool echoed, unsigned long time) {
+  latest[ray] = cm;
+  echo[ray] = echoed;
+  if (ray != rayCenter) {
+    haveAngle = echo[rayLeft] && echo[rayRight] && echo[rayCenter] && sameWall();
+    if (!haveAngle)
+      return;
+    long difference = (long)latest[rayLeft] - (long)latest[rayRight];
+    long ratio = difference * SIDE_RATIO / (long)(latest[rayLeft] + latest[rayRight]); //tan(angle) in Q.14
+    previousAngle = angle;
+    previousAngleTime = angleTime;
+    angle = arctangent(ratio);
+    angleTime = time;
+    fit(fitAngle, angle, (long)(time - windowStart) / 1000);
+  }
+  else if (echoed && haveAngle && measuring && time - windowStart <= 0x7FFFFFFFUL) {
+    //Q2 cm, straight out from the wall, at the angle there was when the sample was taken
+    int cos = cosine((unsigned int)angleAt(time));
+    long distance = ((long)(cm + sensorOffset) * cos) >> 12;
+    //the distance shrinks by speed cos(angle) dt, so against the sum of cos(angle) dt it is a line
+    closing += (long)(((time - closingTime) * (unsigned long)(cos >> 2)) >> 12);
+    closingTime = time;
+    fit(fitDistance, (int)distance, closing / 1000);
+  }
+}
+
+/**
+ * The angle to the wall at time, along the line through the last two side samples
+ */
+int MotorCalibration::angleAt(unsigned long time) const {
+  long span = (long)(angleTime - previousAngleTime);
+  if (span <= 0)
+    return angle;
+  return angle + (int)((long)(angle - previousAngle) * (long)(time - angleTime) / span);
+}
+
+/**
+ * True if all three sensors see the same flat wall, rather than one of them looking past
+ * its end or into a corner.  On a flat wall 1 / left + 1 / right = 2 cos 30 / centre, to
+ * within 1/16 here
+ */
+bool MotorCalibration::sameWall() const {
+  long left = latest[rayLeft], right = latest[rayRight];
+  long sides = latest[rayCenter] * (left + right);
+  long centre = ((left * right) >> 4) * SIDE_COS2 >> 10;
+  return abs(sides - centre) * 16 < sides;
+}
+
+void MotorCalibration::fit(fit_t which, int value, long t) {
+  if (!measuring || t < 0)
+    return;
+  Fit &f = fits[which];
+  f.n++;
+  f.t += t;
+  f.v += value;
+  f.tt += t * t;
+  f.tv += t * value;
+}
+
+/**
+ * Slope of a fitted line in Q4 units per second.  False if there are too few samples
+ */
+bool MotorCalibration::slope(const Fit &fit, long &perSecond) const {
+  if (fit.n < MIN_SAMPLES)
+    return false;
+  long num = fit.n * fit.tv - fit.t * fit.v;
+  long den = fit.n * fit.tt - fit.t * fit.t;
+  if (den < 128)
+    return false;
+  //per ms to Q4 per s is 16000 = 125 * 128, in two parts so that a fast turn does not overflow
+  den >>= 7;
+  long whole = num / den;
+  perSecond = whole * 125 + (num - whole * den) * 125 / den;
+  return true;
+}
+
+/**
+ * Work out the speed of both wheels from a finished window
+ */
+MotorCalibration::result_t MotorCalibration::finishWindow() {
+  long distanceSlope, angleSlope;
+  if (!slope(fits[fitDistance], distanceSlope) || !slope(fits[fitAngle], angleSlope))
+    return resultNoWall;
+  //along the heading, from Q2 cm; closing in is going forward
+  int speed = (int)(-distanceSlope / 4);
+  //the wheels are the yaw rate times half the wheel base either side of that: pi / 65536 per binary angle
+  int half = (int)(angleSlope * wheelBase * 201 / (64L * 65536L));
+  int left = abs(speed - half);
+  int right = abs(speed + half);
+  if (phase == phaseForward) {
+    response[motorLeft][step] = left;
+    response[motorRight][step] = right;
+  }
+  else {
+    response[motorLeft][step] = (response[motorLeft][step] + left) / 2;
+    response[motorRight][step] = (response[motorRight][step] + right) / 2;
+  }
+  return resultRunning;
+}
+
+/**
+ * Smooth the responses into rising curves, and find each wheel's deadband and the top speed
+ * both wheels can make
+ */
+MotorCalibration::result_t MotorCalibration::finishSteps() {
+  for (unsigned char m = 0; m < numMotors; m++) {
+    for (unsigned char i = 0; i < NUM_STEPS; i++) {
+      if (response[m][i] < MOVING_SPEED)
+        response[m][i] = 0;
+      if (i > 0 && response[m][i] < response[m][i - 1])
+        response[m][i] = response[m][i - 1];
+    }
+    unsigned char first = 0;
+    while (first < NUM_STEPS && response[m][first] == 0)
+      first++;
+    if (first >= NUM_STEPS - 1)
+      return resultNoResponse;
+    //extrapolate the first two moving steps back to standing still
+    int rise = response[m][first + 1] - response[m][first];
+    int back = rise > 0 ? (int)((long)response[m][first] * 16 / rise) : 16;
+    int lowest = first > 0 ? stepPwm(first - 1) : 0;
+    int pwm = stepPwm(first) - back;
+    edge[m] = pwm < lowest ? lowest : pwm;
+  }
+  int leftTop = response[motorLeft][NUM_STEPS - 1];
+  int rightTop = response[motorRight][NUM_STEPS - 1];
+  maxSpeed = leftTop < rightTop ? leftTop : rightTop;
+  return maxSpeed < MIN_TOP_SPEED ? resultNoResponse : resultRunning;
+}
+
+/**
+ * PWM that makes motor turn its wheel at speed / 255 of the common top speed
+ */
+unsigned char MotorCalibration::pwmFor(unsigned char motor, unsigned char speed) const {
+  if (speed == 0)
+    return 0;
+  int target = (int)((long)maxSpeed * speed / 255);
+  int previousPwm = edge[motor];
+  int previousSpeed = 0;
+  for (unsigned char i = 0; i < NUM_STEPS; i++) {
+    int pwm = stepPwm(i);
+    int stepSpeed = response[motor][i];
+    if (pwm <= previousPwm || stepSpeed <= previousSpeed)
+      continue;
+    if (stepSpeed >= target)
+      return previousPwm + (int)((long)(pwm - previousPwm) * (target - previousSpeed) / (stepSpeed - previousSpeed));
+    previousPwm = pwm;
+    previousSpeed = stepSpeed;
+  }
+  return 255;
+}
+
+/**
+ * Check the tables in EEPROM.  True if they are complete, with the top speed they are for
+ */
+bool MotorCalibration::load(unsigned int &maxSpeed) {
+  if (EEPROM.read(ADDRESS) != CALIBRATION_MAGIC || EEPROM.read(ADDRESS + 1) != CALIBRATION_VERSION)
+    return false;
+  unsigned char check = 0;
+  for (int i = 0; i < 2 * 256; i++)
+    check = crc8(check, EEPROM.read(TABLE_ADDRESS + i));
+  if (check != EEPROM.read(ADDRESS + 4))
+    return false;
+  maxSpeed = EEPROM.read(ADDRESS + 2) | (EEPROM.read(ADDRESS + 3) << 8);
+  return true;
+}
+
+/**
+ * Print how calibration went and the speed of each wheel, in mm/s, at every PWM step
+ */
+void MotorCalibration::report(Print &out) {
+  out.print(F("calibration "));
+  if (result == resultRunning) {
+    out.println(F("running"));
+    return;
+  }
+  if (result == resultNoWall) {
+    out.println(F("failed, no wall ahead"));
+    return;
+  }
+  if (result == resultNoResponse) {
+    out.println(F("failed, wheels not turning"));
+    return;
+  }
+  out.println(F("done"));
+  out.println(F("pwm left right"));
+  for (unsigned char i = 0; i < NUM_STEPS; i++) {
+    out.print(stepPwm(i));
+    out.print(' ');
+    out.print(response[motorLeft][i] * 10 / 16);
+    out.print(' ');
+    out.println(response[motorRight][i] * 10 / 16);
+  }
+  out.print(F("deadband "));
+  out.print(edge[motorLeft]);
+  out.print(' ');
+  out.println(edge[motorRight]);
+}
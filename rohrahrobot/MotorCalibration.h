@@ -0,0 +1,149 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _MOTOR_CALIBRATION_H_
+#define _MOTOR_CALIBRATION_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Measures how fast each wheel turns for a PWM value and keeps, in EEPROM, a table per
+   * motor from the speed asked for to the PWM that gives it.  With the tables a speed of
+   * 128 is half of 255 on both wheels, and anything above zero gets the wheels turning,
+   * however big the motors' deadbands.
+   *
+   * Calibration needs a flat wall ahead, within a couple of metres.  The robot drives up to
+   * it, then for NUM_STEPS PWM values from 15 to 255 squares up to it, drives toward it and
+   * back away again.
+   * The side sensors, looking 30 degrees either way, give the angle to the wall:
+   * tan(angle) = (left - right) / ((left + right) tan 30), however far away it is.  With
+   * that the centre sensor gives the distance of the middle of the robot from the wall.
+   * After a settling time both go into least squares lines, whose slopes are the speed
+   * and the yaw rate of the robot, which make the speed of each wheel.  Forward and
+   * backward are averaged.
+   *
+   * Each table has 256 entries, one per speed, so looking up a PWM costs one EEPROM read.
+   * Writing them takes a while (3.3ms a byte on the AVR), so it is spread over update()s.
+   *
+   * EEPROM layout from ADDRESS: magic, version, common top speed in Q12.4 cm/s (2 bytes),
+   * CRC-8 of the tables, then the left and the right table.  The magic is written last.
+   */
+  class MotorCalibration {
+    public:
+      enum motor_t {motorLeft, motorRight, numMotors};
+      enum ray_t {rayLeft, rayCenter, rayRight, numRays}; //sensors, as add() takes them
+      enum result_t {resultRunning, resultDone, resultNoWall, resultNoResponse};
+      static const unsigned char NUM_STEPS = 16;
+      static const int ADDRESS = 0;
+      static const int TABLE_ADDRESS = ADDRESS + 5;
+      static const unsigned char SAVE_BYTES_PER_PASS = 4;
+
+      MotorCalibration(unsigned char wheelBase, unsigned char sensorOffset);
+      void start(unsigned long currentTime);
+      result_t update(unsigned long currentTime, int &left, int &right);
+      void add(unsigned char ray, unsigned int cm, bool echoed, unsigned long time);
+      void report(Print &out);
+      result_t getResult() const { return result; }
+
+      static bool load(unsigned int &maxSpeed);
+      static int tableAddress(motor_t motor) { return TABLE_ADDRESS + motor * 256; }
+
+    private:
+      enum phase_t {phaseIdle, phaseApproach, phaseAlign, phaseForward, phaseBackward, phaseSaving};
+
+      enum fit_t {fitDistance, fitAngle, numFits};
+
+      /**
+       * Running sums for a least squares line through (t, v), t in ms from the start of the
+       * window, for the distance each ms weighed by the cosine of the angle to the wall
+       */
+      struct Fit {
+        unsigned char n;
+        long t, v, tt, tv;
+      };
+
+      static unsigned char stepPwm(unsigned char step) { return step * 16 + 15; }
+      void startPhase(phase_t next, unsigned long currentTime);
+      bool sameWall() const;
+      int angleAt(unsigned long time) const;
+      void fit(fit_t which, int value, long t);
+      bool slope(const Fit &fit, long &perSecond) const;
+      result_t finishWindow();
+      result_t finishSteps();
+      unsigned char pwmFor(unsigned char motor, unsigned char speed) const;
+
+      unsigned char wheelBase; //cm
+      unsigned char sensorOffset; //cm from the middle of the robot to the sensors
+      phase_t phase;
+      result_t result;
+      unsigned char step;
+      unsigned long phaseStart; //ms
+      unsigned long windowStart; //us, when the samples start counting
+      bool measuring;
+      unsigned int latest[numRays]; //cm
+      bool echo[numRays];
+      int angle; //binary angle of the wall, counter clockwise from straight ahead
+      int previousAngle;
+      unsigned long angleTime; //us
+      unsigned long previousAngleTime;
+      bool haveAngle;
+      long closing; //us since the window started, each weighed by the cosine of the angle to the wall
+      unsigned long closingTime; //us of the last centre sample
+      Fit fits[numFits];
+      int response[numMotors][NUM_STEPS]; //Q12.4 cm/s at stepPwm(step)
+      unsigned char edge[numMotors]; //PWM the wheel starts turning at
+      int maxSpeed; //Q12.4 cm/s both wheels can reach
+      unsigned int saved; //table bytes written
+      unsigned char crc;
+  };
+
+  /**
+   * Stands in for MotorCalibration in a robot built without it.  'C' only gets a report
+   * saying so, and the motors always run on raw PWM
+   */
+  class NoMotorCalibration {
+    public:
+      NoMotorCalibration(unsigned char /*wheelBase*/, unsigned char /*sensorOffset*/) {}
+      void start(unsigned long /*currentTime*/) {}
+      MotorCalibration::result_t update(unsigned long /*currentTime*/, int &left, int &right) {
+        left = right = 0;
+        return MotorCalibration::resultDone;
+      }
+      void add(unsigned char /*ray*/, unsigned int /*cm*/, bool /*echoed*/, unsigned long /*time*/) {}
+      void report(Print &out) { out.println(F("calibration not built in")); }
+      static bool load(unsigned int &/*maxSpeed*/) { return false; }
+  };
+}
+
+#endif
@@ -35,17 +35,86 @@
 
 namespace rohrah {
 
- class MovingAverage {  
+  /**
+   * floor(log2(N)) at compile time
+   */
+  template <unsigned int N>
+  struct Log2 {
+    static const unsigned char value = 1 + Log2<N / 2>::value;
+  };
+  template <>
+  struct Log2<1> {
+    static const unsigned char value = 0;
+  };
+
+  /**
+   * Divide a window sum by the window size.  Power of two sizes shift instead of dividing
+   */
+  template <unsigned int N, bool POWER_OF_TWO = (N & (N - 1)) == 0>
+  struct WindowDivider {
+    template <typename Acc>
+    static Acc divide(Acc sum) { return sum / (Acc)N; }
+  };
+  template <unsigned int N>
+  struct WindowDivider<N, true> {
+    template <typename Acc>
+    static Acc divide(Acc sum) { return sum >> Log2<N>::value; }
+  };
+
+  /**
+   * Sliding window average over the last N values.
+   * The window lives inside the object, N is fixed at compile time, and Acc is the
+   * type of the running sum, which has to hold N times the largest value of T.
+   * A shorter window can be picked at run time, at the cost of a division per value.
+   *
+   * All the filters (MovingAverage, MedianFilter, ExponentialMovingAverage) share
+   * the same interface: construct with a default value (zero if left out) and a window
+   * (N if left out, ExponentialMovingAverage ignores it), add() returns the new output
+   */
+  template <typename T, unsigned char N, typename Acc = long>
+  class MovingAverage {
     public:
-      MovingAverage(int defaultVal, int length);
-      ~MovingAverage();
-      int add(int newValue);
+      /**
+       * Constructor
+       * Defines a sliding window of size values, all initialized to defaultVal.
+       * Sizes of 0 or over N mean N
+       */
+      MovingAverage(T defaultVal = T(), unsigned char size = N): sum(0), index(0), size(size == 0 || size > N ? N : size) {
+        for (unsigned char i = 0; i < this->size; i++) {
+          buffer[i] = defaultVal;
+          sum += defaultVal;
+        }
+      }
+
+      /**
+       * Adds newValue to the sliding window and removes the oldest value
+       * Returns the newly calculated moving average
+       */
+      T add(T newValue) {
+        sum = sum - buffer[index] + newValue;
+        buffer[index++] = newValue;
+        if (index >= size) {
+          index = 0;
+        }
+        return get();
+      }
+
+      /**
+       * Current average
+       */
+      T get() const {
+        if (size == N)
+          return (T)WindowDivider<N>::divide(sum);
+        return (T)(sum / (Acc)size);
+      }
+
+      unsigned char getSize() const { return size; }
 
     private:
-      int *buffer;
-      int sum;
-      int index;
-      unsigned int size;
+      T buffer[N];
+      Acc sum;
+      unsigned char index;
+      unsigned char size;
   };
 }
-#endif
+#endif
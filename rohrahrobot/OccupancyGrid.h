@@ -0,0 +1,195 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _OCCUPANCY_GRID_H_
+#define _OCCUPANCY_GRID_H_
+
+#include "Trig.h"
+
+namespace rohrah {
+
+  /**
+   * Where the robot has seen obstacles, on a SIZE x SIZE grid of square cells of 2^CELL_SHIFT cm
+   * centred on where the robot started.  Every cell is a 2 bit saturating counter packed
+   * four to a byte: an echo from a cell counts it up, a ping that goes through it counts it
+   * down, and BLOCKED or more means there is something there.  A single stray echo is not
+   * enough to block a cell and a single miss not enough to clear it.
+   *
+   * Rays are stepped cell by cell with Bresenham's algorithm, in integers, and cut at
+   * MAX_RAY cm: further out the pose is too uncertain for the cells to mean much.
+   * Anything off the grid is unknown, which counts as free.
+   */
+  template <unsigned char SIZE, unsigned char CELL_SHIFT>
+  class OccupancyGrid {
+    public:
+      static const unsigned char BLOCKED = 2;
+      static const unsigned char MAX_COUNT = 3;
+      static const unsigned int MAX_RAY = 200; //cm
+
+      OccupancyGrid() { clear(); }
+      void clear();
+      void update(int x, int y, unsigned int bearing, unsigned int cm, bool echo);
+      bool isBlocked(int x, int y, unsigned int bearing, unsigned int cm) const;
+      unsigned char get(int column, int row) const;
+
+    private:
+      /**
+       * Bresenham walk over the cells from (x, y) to cm along bearing, not counting the first
+       */
+      struct Ray {
+        Ray(int x, int y, unsigned int bearing, unsigned int cm);
+        bool next();
+        bool isLast() const { return column == endColumn && row == endRow; }
+        int column, row;
+        int endColumn, endRow;
+        int dx, dy, stepX, stepY, error;
+      };
+
+      static int cellOf(int cm) { return (cm >> CELL_SHIFT) + SIZE / 2; }
+      static bool onGrid(int column, int row) { return column >= 0 && column < SIZE && row >= 0 && row < SIZE; }
+      void set(int column, int row, unsigned char count);
+
+      unsigned char cells[(SIZE * SIZE + 3) / 4];
+  };
+
+  /**
+   * Stands in for an OccupancyGrid in a robot built without a map: remembers nothing and
+   * knows of nothing, so it compiles away
+   */
+  class NoOccupancyGrid {
+    public:
+      void update(int /*x*/, int /*y*/, unsigned int /*bearing*/, unsigned int /*cm*/, bool /*echo*/) {}
+      bool isBlocked(int /*x*/, int /*y*/, unsigned int /*bearing*/, unsigned int /*cm*/) const { return false; }
+  };
+
+  /**
+   * Forget everything
+   */
+  template <unsigned char SIZE, unsigned char CELL_SHIFT>
+  void OccupancyGrid<SIZE, CELL_SHIFT>::clear() {
+    for (unsigned int i = 0; i < sizeof(cells); i++)
+      cells[i] = 0;
+  }
+
+  /**
+   * Count of the cell at column, row.  0 off the grid
+   */
+  template <unsigned char SIZE, unsigned char CELL_SHIFT>
+  unsigned char OccupancyGrid<SIZE, CELL_SHIFT>::get(int column, int row) const {
+    if (!onGrid(column, row))
+      return 0;
+    unsigned int i = (unsigned int)row * SIZE + column;
+    return (cells[i >> 2] >> ((i & 3) << 1)) & 3;
+  }
+
+  template <unsigned char SIZE, unsigned char CELL_SHIFT>
+  void OccupancyGrid<SIZE, CELL_SHIFT>::set(int column, int row, unsigned char count) {
+    unsigned int i = (unsigned int)row * SIZE + column;
+    unsigned char shift = (i & 3) << 1;
+    cells[i >> 2] = (cells[i >> 2] & ~(3 << shift)) | (count << shift);
+  }
+
+  /**
+   * Start a ray at the cell of (x, y), heading for the cell cm along bearing
+   */
+  template <unsigned char SIZE, unsigned char CELL_SHIFT>
+  OccupancyGrid<SIZE, CELL_SHIFT>::Ray::Ray(int x, int y, unsigned int bearing, unsigned int cm) {
+    column = cellOf(x);
+    row = cellOf(y);
+    endColumn = cellOf(x + (int)(((long)cm * cosine(bearing)) >> 14));
+    endRow = cellOf(y + (int)(((long)cm * sine(bearing)) >> 14));
+    dx = endColumn > column ? endColumn - column : column - endColumn;
+    dy = endRow > row ? endRow - row : row - endRow;
+    stepX = endColumn > column ? 1 : -1;
+    stepY = endRow > row ? 1 : -1;
+    error = dx - dy;
+  }
+
+  /**
+   * Step to the next cell.  False at the end of the ray or once it leaves the grid,
+   * which it never comes back to
+   */
+  template <unsigned char SIZE, unsigned char CELL_SHIFT>
+  bool OccupancyGrid<SIZE, CELL_SHIFT>::Ray::next() {
+    if (isLast())
+      return false;
+    int twice = error * 2;
+    if (twice > -dy) {
+      error -= dy;
+      column += stepX;
+    }
+    if (twice < dx) {
+      error += dx;
+      row += stepY;
+    }
+    return onGrid(column, row);
+  }
+
+  /**
+   * A sample of cm taken from (x, y) cm looking along bearing (a binary angle, see Trig.h).
+   * echo is false if the sensor saw nothing within cm.  The cells on the way count down,
+   * the last one up if the echo came from it.  The robot's own cell is left alone
+   */
+  template <unsigned char SIZE, unsigned char CELL_SHIFT>
+  void OccupancyGrid<SIZE, CELL_SHIFT>::update(int x, int y, unsigned int bearing, unsigned int cm, bool echo) {
+    if (cm > MAX_RAY) {
+      cm = MAX_RAY;
+      echo = false;
+    }
+    Ray ray(x, y, bearing, cm);
+    while (ray.next()) {
+      unsigned char count = get(ray.column, ray.row);
+      if (echo && ray.isLast()) {
+        if (count < MAX_COUNT)
+          set(ray.column, ray.row, count + 1);
+      }
+      else if (count > 0) {
+        set(ray.column, ray.row, count - 1);
+      }
+    }
+  }
+
+  /**
+   * True if a blocked cell lies within cm of (x, y) along bearing
+   */
+  template <unsigned char SIZE, unsigned char CELL_SHIFT>
+  bool OccupancyGrid<SIZE, CELL_SHIFT>::isBlocked(int x, int y, unsigned int bearing, unsigned int cm) const {
+    Ray ray(x, y, bearing, cm > MAX_RAY ? MAX_RAY : cm);
+    while (ray.next()) {
+      if (get(ray.column, ray.row) >= BLOCKED)
+        return true;
+    }
+    return false;
+  }
+}
+
+#endif
@@ -0,0 +1,113 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "Odometry.h"
+#include "Trig.h"
+
+using namespace rohrah;
+
+/**
+ * Constructor
+ * maxSpeed is the wheel speed in cm/s at full PWM, deadband the PWM the wheels start
+ * turning at and wheelBase the distance between the wheels in cm
+ */
+Odometry::Odometry(unsigned char maxSpeed, unsigned char deadband, unsigned char wheelBase):
+                   //Q8 of 2^32 per turn over 2 pi wheelBase cm, per Q8.8 cm/s and ms: 2 pi * 256 * 1000 = 1608495
+                   turnScale(0xFFFFFFFFUL / ((1608495UL * wheelBase) >> 8)) {
+  setDriveTrain(maxSpeed * 16, deadband);
+  reset();
+}
+
+/**
+ * Wheel speed model: maxSpeed in Q12.4 cm/s at full output, nothing up to deadband.
+ * With calibrated motors (see MotorCalibration) the deadband is zero
+ */
+void Odometry::setDriveTrain(unsigned int maxSpeed, unsigned char deadband) {
+  if (maxSpeed > MAX_SPEED)
+    maxSpeed = MAX_SPEED; //a calibration may measure more than a wheel speed holds
+  this->deadband = deadband;
+  //Q12 of maxSpeed in Q8.8 cm/s over the output range above the deadband
+  speedScale = (maxSpeed * 65536UL) / (255 - deadband);
+}
+
+/**
+ * Back to the origin, facing along x
+ */
+void Odometry::reset() {
+  x = 0;
+  y = 0;
+  heading = 0;
+  started = false;
+}
+
+/**
+ * Wheel speed in Q8.8 cm/s for a signed PWM output, rounded
+ */
+int Odometry::wheelSpeed(int output) const {
+  int magnitude = output < 0 ? -output : output;
+  if (magnitude <= deadband)
+    return 0;
+  int speed = (int)(((magnitude - deadband) * speedScale + 2048) >> 12);
+  return output < 0 ? -speed : speed;
+}
+
+/**
+ * Integrate the motion since the previous update, with the motors at the given outputs
+ * all along
+ */
+void Odometry::update(int leftOutput, int rightOutput, unsigned long currentTime) {
+  unsigned long dt = currentTime - lastUpdate;
+  lastUpdate = currentTime;
+  if (!started) {
+    started = true;
+    return;
+  }
+  if (dt > MAX_STEP)
+    dt = MAX_STEP;
+  int left = wheelSpeed(leftOutput);
+  int right = wheelSpeed(rightOutput);
+
+  //half the turn before moving, so an arc is followed along its mid heading.  The products
+  //are split so that none overflows a long with both wheels at 127 cm/s, the low parts
+  //shifted on their own, which rounds exactly as shifting the whole would
+  long difference = (long)right - left;
+  long turn = (difference * (long)(turnScale >> 8) + ((difference * (long)(turnScale & 0xFF)) >> 8)) * (long)dt;
+  heading += turn / 2;
+  //mean of the wheels in Q24.8 cm: (left + right) * dt / 2000, where 1 / 2000 is 16777 / 2^25
+  long sum = (((long)left + right) * (long)dt) >> 4;
+  long distance = ((sum >> 7) * 16777L + (((sum & 127) * 16777L) >> 7)) >> 14;
+  unsigned int angle = getHeading();
+  //rounded, as 50 truncations a second would add up to metres in a few minutes
+  x += (distance * cosine(angle) + 8192) >> 14;
+  y += (distance * sine(angle) + 8192) >> 14;
+  heading += turn - turn / 2;
+}
@@ -0,0 +1,82 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _ODOMETRY_H_
+#define _ODOMETRY_H_
+
+namespace rohrah {
+
+  /**
+   * Dead reckoning of the robot's pose from the PWM the motors are driven with.
+   * Each wheel's speed is taken to rise linearly from nothing at the deadband to maxSpeed
+   * at full PWM, and the pose integrates the differential drive kinematics, along the
+   * heading half way through each step.  Integer arithmetic only, in fixed point:
+   *   wheel speeds   Q8.8 cm/s in an int (up to 127 cm/s)
+   *   x and y        Q24.8 cm from where the robot started, in a long (80km either way)
+   *   heading        Q16.16 binary angle (see Trig.h) from the direction it started in,
+   *                  counter clockwise, in an unsigned long.  The fraction keeps slow
+   *                  turns from being rounded away at 50 updates a second
+   *   sine, cosine   Q1.14
+   *
+   * Without wheel encoders this drifts, with the battery, on slippery floors and every
+   * time the robot pushes against something, so it is good for remembering the last few
+   * metres, not for navigating a house.
+   */
+  class Odometry {
+    public:
+      Odometry(unsigned char maxSpeed, unsigned char deadband, unsigned char wheelBase);
+      void setDriveTrain(unsigned int maxSpeed, unsigned char deadband);
+      void update(int leftOutput, int rightOutput, unsigned long currentTime);
+      void reset();
+
+      int getX() const { return (int)(x >> 8); } //cm
+      int getY() const { return (int)(y >> 8); } //cm
+      unsigned int getHeading() const { return (unsigned int)(heading >> 16) & 0xFFFF; } //wider longs off the AVR
+
+    private:
+      static const unsigned long MAX_STEP = 50; //ms, longer gaps are integrated as this
+      static const unsigned int MAX_SPEED = 127 * 16; //Q12.4 cm/s, the most a wheel speed holds
+
+      int wheelSpeed(int output) const;
+
+      unsigned char deadband; //PWM below which the wheels stand still
+      unsigned long speedScale; //Q12 wheel speed per PWM above the deadband
+      unsigned long turnScale; //Q8 heading units per Q8.8 cm/s of wheel speed difference per ms
+      long x; //Q24.8 cm
+      long y; //Q24.8 cm
+      unsigned long heading; //Q16.16 binary angle
+      unsigned long lastUpdate;
+      bool started;
+  };
+}
+
+#endif
@@ -0,0 +1,92 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <avr/sleep.h>
+#include "PowerSaver.h"
+
+using namespace rohrah;
+
+/**
+ * Constructor
+ */
+PowerSaver::PowerSaver(): sleeps(0), asleepTime(0), lateWakes(0), latencySum(0), maxLatency(0), windowStart(0) {
+}
+
+/**
+ * Sleep until the next interrupt, unless the next task is due (nextDue, in micros()) too
+ * soon for that to be worth it.  Call once per pass of the loop while idle
+ */
+void PowerSaver::sleep(unsigned long nextDue) {
+  unsigned long start = micros();
+  if ((long)(nextDue - start) < (long)MIN_SLEEP)
+    return;
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  sleep_cpu();
+  sleep_disable();
+  unsigned long end = micros();
+  asleepTime += end - start;
+  sleeps++;
+  long late = (long)(end - nextDue);
+  if (late >= 0) {
+    latencySum += late;
+    if ((unsigned long)late > maxLatency)
+      maxLatency = late > 0xFFFF ? 0xFFFF : late;
+    if (++lateWakes == 0xFFFF) {
+      lateWakes >>= 1;
+      latencySum >>= 1;
+    }
+  }
+}
+
+/**
+ * Print the number of sleeps since the last report, the share of the time spent asleep,
+ * then the mean and longest wake latency in us.  Starts a new reporting window
+ */
+void PowerSaver::report(Print &out) {
+  unsigned long window = micros() - windowStart;
+  out.println(F("sleeps asleep latency max"));
+  out.print(sleeps);
+  out.print(' ');
+  out.print(asleepTime / (window / 100 + 1));
+  out.print(F("% "));
+  out.print(lateWakes ? latencySum / lateWakes : 0);
+  out.print(' ');
+  out.println(maxLatency);
+  sleeps = 0;
+  asleepTime = 0;
+  lateWakes = 0;
+  latencySum = 0;
+  maxLatency = 0;
+  windowStart = micros();
+}
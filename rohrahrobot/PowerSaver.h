@@ -0,0 +1,70 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _POWER_SAVER_H_
+#define _POWER_SAVER_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Sleeps the CPU while the robot has nothing to do.
+   * sleep() puts the ATmega in idle mode, which stops the CPU clock and nothing else, so
+   * every interrupt wakes it: an echo edge, a byte on the Bluetooth link (SoftwareSerial's
+   * pin change interrupt or the UART's), the UART sending a byte, and at the latest timer 0,
+   * which keeps millis() going every 1024us.  Nothing has to be set up to wake on time,
+   * and a task can be no more than one timer 0 period late for it.
+   *
+   * It keeps count of the sleeps and the time spent asleep, and of the wake latency, how
+   * late the task that was next due got to run because the CPU was asleep when it came due
+   */
+  class PowerSaver {
+    public:
+      static const unsigned int MIN_SLEEP = 100; //us, a task due sooner than this is just waited for
+
+      PowerSaver();
+      void sleep(unsigned long nextDue);
+      void report(Print &out);
+
+    private:
+      unsigned long sleeps;
+      unsigned long asleepTime; //us since the last report
+      unsigned int lateWakes; //sleeps that ended after the next task was due
+      unsigned long latencySum; //us over those
+      unsigned int maxLatency; //us
+      unsigned long windowStart;
+  };
+}
+
+#endif
@@ -0,0 +1,176 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "Profiler.h"
+using namespace rohrah;
+
+/**
+ * Constructor
+ */
+Profiler::Profiler() {
+  reset();
+}
+
+/**
+ * Forget everything measured so far
+ */
+void Profiler::reset() {
+  for (int i = 0; i < numStages; i++) {
+    stats[i].minTime = 0xFFFF;
+    stats[i].maxTime = 0;
+    stats[i].totalTime = 0;
+    stats[i].count = 0;
+    for (int b = 0; b < NUM_BUCKETS / 2; b++)
+      stats[i].buckets[b] = 0;
+    passTime[i] = 0;
+  }
+  touched = 0;
+  lastMark = micros();
+}
+
+/**
+ * Start of a pass of the loop
+ */
+void Profiler::begin() {
+  for (int i = 0; i < numStages; i++)
+    passTime[i] = 0;
+  touched = 0;
+  lastMark = micros();
+}
+
+/**
+ * Charge the time since the previous mark to stage
+ */
+void Profiler::mark(stage_t stage) {
+  unsigned long now = micros();
+  unsigned long elapsed = now - lastMark;
+  lastMark = now;
+  unsigned long total = passTime[stage] + elapsed;
+  passTime[stage] = total > 0xFFFF ? 0xFFFF : total;
+  touched |= (1 << stage);
+}
+
+/**
+ * Charge the time since startMicros to stage, and take it out of whatever the
+ * next mark() charges.  For stages nested inside another one, like motor writes
+ * in the middle of a decision
+ */
+void Profiler::section(stage_t stage, unsigned long startMicros) {
+  unsigned long elapsed = micros() - startMicros;
+  lastMark += elapsed;
+  unsigned long total = passTime[stage] + elapsed;
+  passTime[stage] = total > 0xFFFF ? 0xFFFF : total;
+  touched |= (1 << stage);
+}
+
+/**
+ * End of a pass.  Every stage that ran during the pass gets one sample
+ */
+void Profiler::end() {
+  for (int i = 0; i < numStages; i++) {
+    if (touched & (1 << i))
+      record(stats[i], passTime[i]);
+  }
+  touched = 0;
+}
+
+/**
+ * Count of bucket b of a stage
+ */
+unsigned char Profiler::bucket(const Stats &s, unsigned char b) {
+  return b & 1 ? s.buckets[b >> 1] >> 4 : s.buckets[b >> 1] & 0x0F;
+}
+
+/**
+ * Add one sample to a stage.  Counters are halved rather than allowed to overflow,
+ * so old samples slowly age out and the histogram keeps its shape
+ */
+void Profiler::record(Stats &s, unsigned int time) {
+  if (time < s.minTime)
+    s.minTime = time;
+  if (time > s.maxTime)
+    s.maxTime = time;
+  if (s.count == 0xFFFF) {
+    s.count >>= 1;
+    s.totalTime >>= 1;
+  }
+  s.count++;
+  s.totalTime += time;
+
+  unsigned char slot = 0;
+  while (time != 0 && slot < NUM_BUCKETS - 1) {
+    time >>= 1;
+    slot++;
+  }
+  if (bucket(s, slot) == 0x0F) {
+    //halve both counters of every byte at once, without the low bit of the high one
+    for (int b = 0; b < NUM_BUCKETS / 2; b++)
+      s.buckets[b] = (s.buckets[b] >> 1) & 0x77;
+  }
+  s.buckets[slot >> 1] += slot & 1 ? 0x10 : 0x01;
+}
+
+/**
+ * Print one line per stage: name, min, max and mean in us, sample count and the histogram.
+ * The time spent printing is not charged to any stage
+ */
+void Profiler::report(Print &out) {
+  out.println(F("stage min max mean count | log2 us histogram"));
+  for (int i = 0; i < numStages; i++) {
+    Stats &s = stats[i];
+    switch (i) {
+      case stageSensing: out.print(F("sense")); break;
+      case stageReceive: out.print(F("receive")); break;
+      case stageProcess: out.print(F("process")); break;
+      case stageDecision: out.print(F("decide")); break;
+      case stageMotors: out.print(F("motors")); break;
+      case stageBlink: out.print(F("blink")); break;
+      case stageTelemetry: out.print(F("telemetry")); break;
+      case stageLog: out.print(F("log")); break;
+    }
+    out.print(' ');
+    out.print(s.count ? s.minTime : 0);
+    out.print(' ');
+    out.print(s.maxTime);
+    out.print(' ');
+    out.print(s.count ? s.totalTime / s.count : 0);
+    out.print(' ');
+    out.print(s.count);
+    out.print(F(" |"));
+    for (int b = 0; b < NUM_BUCKETS; b++) {
+      out.print(' ');
+      out.print(bucket(s, b));
+    }
+    out.println();
+  }
+  begin();
+}
@@ -0,0 +1,97 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+// Uncomment to time the stages of Robot::run().  Costs 165 bytes of SRAM on the Uno
+//#define PROFILING
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Per-stage loop latency statistics.
+   * Each pass of the loop is split into stages with mark().  Per stage the profiler keeps
+   * the min, max and mean time spent per pass and a histogram with log2 buckets:
+   * bucket 0 counts passes taking 0us, bucket k passes taking 2^(k-1) to 2^k - 1 us,
+   * and the last bucket everything slower.  Buckets are 4 bit counters, two to a byte, so
+   * the histogram shows the shape of the last few dozen passes rather than totals.
+   */
+  class Profiler {
+    public:
+      enum stage_t {stageSensing, stageReceive, stageProcess, stageDecision, stageMotors, stageBlink, stageTelemetry, stageLog, numStages};
+      static const unsigned char NUM_BUCKETS = 16;
+
+      Profiler();
+      void reset();
+      void begin();
+      void mark(stage_t stage);
+      void section(stage_t stage, unsigned long startMicros);
+      void end();
+      void report(Print &out);
+
+    private:
+      struct Stats {
+        unsigned int minTime;
+        unsigned int maxTime;
+        unsigned long totalTime;
+        unsigned int count;
+        unsigned char buckets[NUM_BUCKETS / 2]; //two 4 bit counters per byte, the even bucket low
+      };
+
+      void record(Stats &stats, unsigned int time);
+      static unsigned char bucket(const Stats &stats, unsigned char b);
+
+      Stats stats[numStages];
+      unsigned int passTime[numStages];
+      unsigned char touched;
+      unsigned long lastMark;
+  };
+}
+
+#ifdef PROFILING
+#define PROFILE_BEGIN() profiler.begin()
+#define PROFILE_MARK(stage) profiler.mark(Profiler::stage)
+#define PROFILE_START(var) unsigned long var = micros()
+#define PROFILE_SECTION(stage, var) profiler.section(Profiler::stage, var)
+#define PROFILE_END() profiler.end()
+#else
+#define PROFILE_BEGIN()
+#define PROFILE_MARK(stage)
+#define PROFILE_START(var)
+#define PROFILE_SECTION(stage, var)
+#define PROFILE_END()
+#endif
+
+#endif
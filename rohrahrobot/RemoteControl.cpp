@@ -30,18 +30,63 @@
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 
+#include <Arduino.h>
 #include "RemoteControl.h"
+#include "Trace.h"
+#include "LinkQueue.h"
 using namespace rohrah;
 
+#define MAX_SPEED 255
+
 /**
  * Constructor 
- * Initialze the Bluetooth Serial object
+ * Initialze the Bluetooth link
  */
-RemoteControl::RemoteControl(SoftwareSerial *ss): btSerial(ss) {
+RemoteControl::RemoteControl(Transport *transport): link(transport), lastReceived(0), frames(0), pinged(false), probed(false),
+                                                    probeSequence(0), probeSent(0), probeReceived(0) {
+}
+
+/**
+ * Recieve commands from the transmitter and parse them
+ * Every byte waiting on the link is processed in one call, so a burst of key presses
+ * is applied at once and only the resulting latest command is returned.
+ * Commands that change the robot's mode end the batch early, so that they are acted on
+ * before anything that was sent after them.
+ *
+ * Two protocols can be mixed on the link: single character commands (see parseCharacter)
+ * and binary frames (see Frame.h and parseFrame).  A frame that has had no byte for
+ * FRAME_TIMEOUT ms is dropped, and what comes next is read afresh
+ * 
+ * Returns true if a command was received on the bluetooth terminal, false otherwise
+ */
+bool RemoteControl::receiveAndParseCommand(unsigned long currentTime) {
+  bool received = false;
+  if (link->available() > 0) {
+    if (currentTime - lastReceived > FRAME_TIMEOUT)
+      parser.abandon();
+    lastReceived = currentTime;
+  }
+  while (link->available() > 0) {
+    unsigned char ch = link->read();
+    Trace::received(ch);
+    bool done = false;
+    if (parser.isIdle() && ch != FRAME_SYNC) {
+      done = parseCharacter(ch);
+      received = true;
+    }
+    else if (parser.parse(ch)) {
+      frames++;
+      done = parseFrame();
+      if (parser.getType() != FRAME_PING && parser.getType() != FRAME_PONG) //not commands
+        received = true;
+    }
+    if (done)
+      break;
+  }
+  return received;
 }
 
 /**
- * Recieve command from the transmitter and parse the command
  * The protocol is such that each command consists of single character
  * If 'a' is received, the command is to move left
  * If 'd' is received, the command is to move right
@@ -50,16 +95,19 @@ RemoteControl::RemoteControl(SoftwareSerial *ss): btSerial(ss) {
  * If 's' is received, the command is to stop
  * If 'A' is received, the command is to set the robot to Auto mode
  * If 'R' is received, the command is to set the robot to Manual mode (or take control)
- * 
- * Returns true if a character is received on the bluetooth terminal, false otherwise
+ * If 'P' is received, the command is to report the loop profile
+ * If 'T' is received, the command is to switch telemetry on or off
+ * If 'G' is received, the command is to switch the speed governor on or off
+ * If 'O' is received, the command is to report the dead reckoned pose
+ * If 'C' is received, the command is to calibrate the motors against a wall ahead
+ * If 'M' is received, the command is to report the least free stack since reset
+ * If 'W' is received, the command is to report the wheel speed tracking error
+ * If 'S' is received, the command is to run the motion script uploaded last
+ * If 'L' is received, the command is to report the link's round trip times
+ *
+ * Returns true if the command has to be acted on before any further input
  */
-bool RemoteControl::receiveAndParseCommand() {
-  if (btSerial->available() <= 0) 
-    return false;
-      
-  //read data from Bluetooth
-  char ch = btSerial->read();
-  
+bool RemoteControl::parseCharacter(char ch) {
   switch (ch) {
     case 'a': //left
       command.setKeyType(RemoteControlCommand::moveCommand);
@@ -83,13 +131,126 @@ bool RemoteControl::receiveAndParseCommand() {
       break;
     case 'A': //auto
       command.setKeyType(RemoteControlCommand::autoCommand);
-      break;
+      return true;
     case 'R': //take control
       command.setKeyType(RemoteControlCommand::controlCommand);
+      return true;
+    case 'P': //profile
+      command.setKeyType(RemoteControlCommand::profileCommand);
+      return true;
+    case 'T': //telemetry
+      command.setKeyType(RemoteControlCommand::telemetryCommand);
+      command.setTelemetryPeriod(TELEMETRY_TOGGLE);
+      return true;
+    case 'G': //speed governor
+      command.setKeyType(RemoteControlCommand::governorCommand);
+      return true;
+    case 'O': //odometry
+      command.setKeyType(RemoteControlCommand::poseCommand);
+      return true;
+    case 'C': //calibrate
+      command.setKeyType(RemoteControlCommand::calibrateCommand);
+      return true;
+    case 'M': //memory
+      command.setKeyType(RemoteControlCommand::memoryCommand);
+      return true;
+    case 'W': //wheels
+      command.setKeyType(RemoteControlCommand::wheelsCommand);
+      return true;
+    case 'S': //script
+      command.setKeyType(RemoteControlCommand::scriptCommand);
+      return true;
+    case 'L': //link
+      command.setKeyType(RemoteControlCommand::linkCommand);
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
+/**
+ * Act on a complete frame
+ * FRAME_DRIVE carries a mode byte, controlCommand, autoCommand or moveCommand as the keys
+ * 'R', 'A' and the driving keys set them, and absolute left and right speeds, which are
+ * used with moveCommand
+ * FRAME_TELEMETRY sets the telemetry period
+ * FRAME_WATCHDOG sets the window of the link watchdog, see LinkMonitor
+ * FRAME_PING is echoed at once and FRAME_PONG kept for takeProbe().  Neither is a command
+ * FRAME_SCRIPT is a chunk of a motion script, an uploadCommand.  It ends the batch, the
+ * chunk is only there to getUpload() until the next byte is parsed
+ *
+ * Returns true if the command has to be acted on before any further input
+ */
+bool RemoteControl::parseFrame() {
+  const unsigned char *payload = parser.getPayload();
+  switch (parser.getType()) {
+    case FRAME_DRIVE:
+      if (parser.getLength() < 5 || (payload[0] != RemoteControlCommand::controlCommand &&
+          payload[0] != RemoteControlCommand::autoCommand && payload[0] != RemoteControlCommand::moveCommand))
+        return false;
+      command.setKeyType((RemoteControlCommand::key_t)payload[0]);
+      if (payload[0] == RemoteControlCommand::moveCommand) {
+        command.setLeftSpeed(constrain(readInt16(payload + 1), -MAX_SPEED, MAX_SPEED));
+        command.setRightSpeed(constrain(readInt16(payload + 3), -MAX_SPEED, MAX_SPEED));
+        return false;
+      }
+      return true;
+    case FRAME_TELEMETRY:
+      if (parser.getLength() < 2)
+        return false;
+      command.setKeyType(RemoteControlCommand::telemetryCommand);
+      command.setTelemetryPeriod((unsigned int)readInt16(payload));
+      return true;
+    case FRAME_SCRIPT:
+      command.setKeyType(RemoteControlCommand::uploadCommand);
+      return true;
+    case FRAME_WATCHDOG:
+      if (parser.getLength() < 2)
+        return false;
+      command.setKeyType(RemoteControlCommand::watchdogCommand);
+      command.setLinkTimeout(readUint16(payload));
+      return true;
+    case FRAME_PING:
+      pinged = true;
+      echo();
+      break;
+    case FRAME_PONG:
+      if (parser.getLength() < 5)
+        return false;
+      probed = true;
+      probeSequence = payload[0];
+      probeSent = readUint32(payload + 1);
+      probeReceived = micros();
       break;
     default:
       break;
   }
+  return false;
+}
+
+/**
+ * Send the payload of a FRAME_PING straight back, up to FRAME_MAX_PING bytes of it, after
+ * the frame that is going out, if any
+ */
+void RemoteControl::echo() {
+  unsigned char length = parser.getLength() < FRAME_MAX_PING ? parser.getLength() : FRAME_MAX_PING;
+  unsigned char frame[FRAME_MAX_PING + FRAME_OVERHEAD];
+  LinkQueue::finish(*link);
+  link->write(frame, encodeFrame(frame, FRAME_ECHO, parser.getPayload(), length));
+}
+
+/**
+ * The latest of the robot's probes to come back since the last call, if one did: its
+ * sequence number, when it went out and when it came back, in us.  False if none did
+ */
+bool RemoteControl::takeProbe(unsigned char &sequence, unsigned long &sent, unsigned long &received) {
+  if (!probed)
+    return false;
+  probed = false;
+  sequence = probeSequence;
+  sent = probeSent;
+  received = probeReceived;
   return true;
 }
 
@@ -99,4 +260,4 @@ bool RemoteControl::receiveAndParseCommand() {
 RemoteControlCommand RemoteControl::getCommand() {
   return command;
 }
-
+
@@ -33,22 +33,41 @@
 #ifndef _REMOTE_CONTROL_H_
 #define _REMOTE_CONTROL_H_
 
-#include <SoftwareSerial.h>
+#include "Transport.h"
 #include "RemoteControlCommand.h"
+#include "Frame.h"
 
 
 namespace rohrah {
 
   class RemoteControl {
     public:
-      RemoteControl(SoftwareSerial *ss);
-      bool receiveAndParseCommand();
+      RemoteControl(Transport *transport);
+      bool receiveAndParseCommand(unsigned long currentTime);
       RemoteControlCommand getCommand();
+      const unsigned char *getUpload() const { return parser.getPayload(); }
+      unsigned char getUploadLength() const { return parser.getLength(); }
+      void stop() { command.stop(); }
+      unsigned char getFrames() const { return frames; }
+      bool isPinged() const { return pinged; }
+      bool takeProbe(unsigned char &sequence, unsigned long &sent, unsigned long &received);
       
     private:
+      bool parseCharacter(char ch);
+      bool parseFrame();
+      void echo();
+
       RemoteControlCommand command;
-      SoftwareSerial *btSerial;
+      FrameParser parser;
+      Transport *link;
+      unsigned long lastReceived; //ms, the control pass the latest byte came in
+      unsigned char frames; //valid ones received, wraps around
+      bool pinged; //the remote has sent a FRAME_PING, so it takes part in the link checks
+      bool probed; //a FRAME_PONG came back that takeProbe() has not taken yet
+      unsigned char probeSequence;
+      unsigned long probeSent; //us, by the robot's clock
+      unsigned long probeReceived;
   };
 }
 
-#endif
+#endif
@@ -40,7 +40,8 @@ using namespace rohrah;
  * Constructor
  * Initialze the motor speeds to zero and the command to manual mode
  */
-RemoteControlCommand::RemoteControlCommand(): leftSpeed(0), rightSpeed(0), key(controlCommand) {}
+RemoteControlCommand::RemoteControlCommand(): leftSpeed(0), rightSpeed(0), key(controlCommand),
+                                             telemetryPeriod(TELEMETRY_TOGGLE), linkTimeout(0) {}
 
 /**
  * Destructor
@@ -174,7 +175,7 @@ int RemoteControlCommand::getRightSpeed() {
 }
 
 /**
- * Set the command's key type to either 'auto' 'manual' or 'move' type
+ * Set the command's key type to either 'auto' 'manual' 'move' 'profile' or 'telemetry' type
  */
 void RemoteControlCommand::setKeyType(key_t type) {
   key = type;
@@ -186,4 +187,32 @@ void RemoteControlCommand::setKeyType(key_t type) {
 RemoteControlCommand::key_t RemoteControlCommand::getKeyType() {
   return key;
 }
-
+
+/**
+ * Set the telemetry period in ms that goes with a telemetry command.
+ * 0 switches telemetry off, TELEMETRY_TOGGLE toggles it
+ */
+void RemoteControlCommand::setTelemetryPeriod(unsigned int period) {
+  telemetryPeriod = period;
+}
+
+/**
+ * Return the telemetry period of a telemetry command
+ */
+unsigned int RemoteControlCommand::getTelemetryPeriod() {
+  return telemetryPeriod;
+}
+
+/**
+ * Set the window in ms that goes with a watchdog command, 0 switches the watchdog off
+ */
+void RemoteControlCommand::setLinkTimeout(unsigned int timeout) {
+  linkTimeout = timeout;
+}
+
+/**
+ * Return the window of a watchdog command
+ */
+unsigned int RemoteControlCommand::getLinkTimeout() {
+  return linkTimeout;
+}
@@ -33,13 +33,15 @@
 #ifndef _REMOTE_CONTROL_COMMAND_H_
 #define _REMOTE_CONTROL_COMMAND_H_
 
+#define TELEMETRY_TOGGLE 0xFFFF //telemetry period that switches it on if it is off and off if it is on
+
 namespace rohrah {
 
   class RemoteControlCommand {
     public:
       RemoteControlCommand();
       ~RemoteControlCommand();
-      enum key_t {controlCommand, autoCommand, moveCommand}; 
+      enum key_t {controlCommand, autoCommand, moveCommand, profileCommand, telemetryCommand, governorCommand, poseCommand, calibrateCommand, memoryCommand, wheelsCommand, scriptCommand, linkCommand, watchdogCommand, uploadCommand, numCommands}; 
       void incrementForward();
       void incrementBackward();
       void incrementLeft();
@@ -51,12 +53,18 @@ namespace rohrah {
       int getRightSpeed();
       key_t getKeyType();
       void setKeyType(key_t type);
+      unsigned int getTelemetryPeriod();
+      void setTelemetryPeriod(unsigned int period);
+      unsigned int getLinkTimeout();
+      void setLinkTimeout(unsigned int timeout);
       
     private:
       int leftSpeed;
       int rightSpeed;
-      key_t key;       
+      key_t key;
+      unsigned int telemetryPeriod;
+      unsigned int linkTimeout;
   };
 }
 
-#endif
+#endif
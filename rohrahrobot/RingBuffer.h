@@ -0,0 +1,81 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _RING_BUFFER_H_
+#define _RING_BUFFER_H_
+
+namespace rohrah {
+
+  /**
+   * Fixed size byte FIFO.  SIZE must be a power of two no larger than 256 and the
+   * buffer holds up to SIZE - 1 bytes.  One producer and one consumer may run in
+   * different contexts (e.g. an interrupt and the loop) without locking
+   */
+  template <unsigned int SIZE>
+  class RingBuffer {
+    public:
+      RingBuffer(): head(0), tail(0) {}
+
+      unsigned char available() const { return (unsigned char)((head - tail) & (SIZE - 1)); }
+      unsigned char space() const { return (unsigned char)(SIZE - 1 - available()); }
+      bool isEmpty() const { return head == tail; }
+      void clear() { tail = head; }
+
+      bool put(unsigned char b) {
+        unsigned char next = (head + 1) & (SIZE - 1);
+        if (next == tail)
+          return false;
+        buffer[head] = b;
+        head = next;
+        return true;
+      }
+
+      int get() {
+        if (head == tail)
+          return -1;
+        unsigned char b = buffer[tail];
+        tail = (tail + 1) & (SIZE - 1);
+        return b;
+      }
+
+      int peek(unsigned char offset = 0) const {
+        return offset >= available() ? -1 : buffer[(tail + offset) & (SIZE - 1)];
+      }
+
+    private:
+      unsigned char buffer[SIZE];
+      volatile unsigned char head;
+      volatile unsigned char tail;
+  };
+}
+
+#endif
@@ -32,55 +32,787 @@
 #ifndef _ROBOT_H_
 #define _ROBOT_H_
 
-#include <SoftwareSerial.h>
-#include "Motor.h"
+#include "RobotConfig.h"
 #include "DistanceSensor.h"
 #include "RemoteControl.h"
-#include "MovingAverage.h"
-
+#include "SensorArray.h"
+#include "Odometry.h"
+#include "Profiler.h"
+#include "PowerSaver.h"
+#include "StackMonitor.h"
+#include "TurnScanner.h"
+#include "Scheduler.h"
+#include "Trace.h"
+#include "LinkQueue.h"
+#include "Logger.h"
 
 namespace rohrah {
 
+  /**
+   * What auto mode is tuned by.  Robot::defaultParameters holds the values the robot
+   * ships with, the sweep tool in host/sweep looks for better ones
+   */
+  struct RobotParameters {
+    unsigned int minDistance; //cm, an obstacle this close makes the robot turn
+    unsigned char filterWindow; //samples averaged per sensor, up to the config's FILTER_WINDOW
+    unsigned int minTurnTime; //ms, a turn lasts at least this long
+    unsigned int maxTurnTime; //ms, and less than this
+    unsigned int scanArc; //degrees a turn spins through looking for the most open way, 0 for a turn of random length
+    unsigned int runTime; //s auto mode runs for
+  };
+
+  // names of the scheduled tasks, in PROGMEM, see Robot.cpp
+  extern const char scriptTaskName[];
+  extern const char controlTaskName[];
+  extern const char rangingTaskName[];
+  extern const char telemetryTaskName[];
+  extern const char blinkTaskName[];
+
+  /**
+   * The ultrasonic sensors of a robot with N of them, and the slots of the sensor array
+   * they go in.  Three look ahead and about 30 degrees to either side, in the order of
+   * MotorCalibration::ray_t, one looks ahead only
+   */
+  template<class Config, unsigned char N = Config::NUM_SENSORS>
+  struct RangeFinders;
+
+  template<class Config>
+  struct RangeFinders<Config, 1> {
+    DistanceSensor center;
+    RangeFinders(): center(Config::TRIGGER_PIN, Config::ECHO_PIN, Config::MAX_DISTANCE_TO_TRACK) {}
+    template<class ARRAY>
+    void attach(ARRAY &sensors) { sensors.attach(0, &center); }
+  };
+
+  template<class Config>
+  struct RangeFinders<Config, 3> {
+    DistanceSensor left;
+    DistanceSensor center;
+    DistanceSensor right;
+    RangeFinders(): left(Config::LEFT_TRIGGER_PIN, Config::ECHO_PIN, Config::MAX_DISTANCE_TO_TRACK),
+                    center(Config::TRIGGER_PIN, Config::ECHO_PIN, Config::MAX_DISTANCE_TO_TRACK),
+                    right(Config::RIGHT_TRIGGER_PIN, Config::ECHO_PIN, Config::MAX_DISTANCE_TO_TRACK) {}
+    template<class ARRAY>
+    void attach(ARRAY &sensors) {
+      sensors.attach(0, &left);
+      sensors.attach(1, &center);
+      sensors.attach(2, &right);
+    }
+  };
+
+  /**
+   * The robot, built to a compile time configuration such as StandardConfig (see RobotConfig.h)
+   */
+  template<class Config>
   class Robot {
     public:
-      Robot(SoftwareSerial *ss);
+      typedef typename Config::Link Link;
+      static const RobotParameters defaultParameters;
+
+      Robot(Link *transport, const RobotParameters &parameters = defaultParameters);
       ~Robot();
       void run();
       void initialize();
+      void begin();
 
    protected:
+      typedef typename Config::Filter Filter;
+      typedef typename Config::MotorDriver MotorDriver;
+      typedef typename Config::Calibrator Calibrator;
+      typedef DistanceVector<Config::NUM_SENSORS> Distances;
+      //slots of the sensors in the sensor array; with one sensor all three are the same
+      static const unsigned char SENSOR_LEFT = 0;
+      static const unsigned char SENSOR_CENTER = Config::NUM_SENSORS / 2;
+      static const unsigned char SENSOR_RIGHT = Config::NUM_SENSORS - 1;
+
       void move();
       void stop();
-      void turn(unsigned long currentTime);
-      bool doneTurning(unsigned long currentTime, unsigned int distance);
-      bool obstacleAhead(unsigned int distance);
+      void turn(unsigned long currentTime, const Distances &distances);
+      void spin(bool left);
+      bool doneTurning(unsigned long currentTime, const Distances &distances);
+      bool obstacleAhead(const Distances &distances);
+      bool knownBlocked(int bearing);
       void controlByRemote();
-      void switchToAutoControl();
+      void switchToAutoControl(unsigned long currentTime);
       bool doneRunning(unsigned long currentTime);
-      void processCommand(RemoteControlCommand &command);
+      void processCommand(RemoteControlCommand &command, unsigned long currentTime);
+      void gateRange();
+      void cruise();
+      void reportPose();
+      void startCalibration(unsigned long currentTime);
+      void loadCalibration();
+      void startScript();
+      void endScript();
+      void updateIdle(unsigned long currentTime);
       
       bool isMoving() { return (currentState == stateMoving); }
       bool isStopped() { return (currentState == stateStopped); }
       bool isTurning() { return (currentState == stateTurning); }
       bool isRemoteControlled() { return (currentState == stateRemote); }
+      bool isCalibrating() { return (currentState == stateCalibrating); }
+      bool isScripted() { return (currentState == stateScripted); }
       
-      void blink(unsigned long currentTime);
+      void drive(int leftSpeed, int rightSpeed);
+      void replaySample(unsigned char index, unsigned int cm, bool echo, unsigned long time);
+      void useSample(unsigned char index);
+
+      //scheduled tasks
+      void scriptTask(unsigned long currentTime);
+      void controlTask(unsigned long currentTime);
+      void rangingTask(unsigned long currentTime);
+      void telemetryTask(unsigned long currentTime);
+      void blinkTask(unsigned long currentTime);
           
     private:
-      Motor leftMotor;
-      Motor rightMotor;
-      DistanceSensor distanceSensor;
-      MovingAverage averageDistance;
+      enum task_t {taskScript, taskControl, taskRanging, taskTelemetry, taskBlink, numTasks}; //highest priority first
+      typedef Scheduler<Robot, numTasks> TaskScheduler;
+      static const typename TaskScheduler::Task tasks[numTasks];
+
+      RobotParameters parameters;
+      MotorDriver leftMotor;
+      MotorDriver rightMotor;
+      RangeFinders<Config> rangeFinders;
+      SensorArray<Config::NUM_SENSORS, Filter> sensors;
+      typename Config::Governor governor;
+      Odometry odometry;
+      typename Config::Map obstacles;
+      TurnScanner scanner;
+      Calibrator calibration;
       RemoteControl remoteControl;
-      enum state_t {stateStopped, stateMoving, stateTurning, stateRemote };
+      enum state_t {stateStopped, stateMoving, stateTurning, stateRemote, stateCalibrating, stateScripted };
       state_t currentState;
       unsigned long endStateTime;
-      unsigned long endBlinkTime;
       bool isLedOn;
       unsigned long endTime;
-      SoftwareSerial *btSerial;
+      int distance;
+      unsigned int rawDistance;
+      Link *link;
+      TaskScheduler scheduler;
+      typename Config::Telemeter telemetry;
+      typename Config::SpeedControl speedControl;
+      typename Config::Script script;
+      typename Config::LinkWatch linkWatch;
+      unsigned int loopTime; //us, longest pass of run() since the last telemetry sample
+      RemoteControlCommand::key_t lastCommand;
+      PowerSaver powerSaver;
+      bool idle; //nothing to do, the sensors are off and run() sleeps between tasks
+      unsigned long lastActive; //ms, the last command
+#ifdef PROFILING
+      Profiler profiler;
+#endif
   };
- 
+
+  /**
+   * What runs how often, in order of priority.  Telemetry only runs when switched on, the
+   * script task while a motion script runs
+   */
+  template<class Config>
+  const typename Robot<Config>::TaskScheduler::Task Robot<Config>::tasks[Robot<Config>::numTasks] = {
+    { scriptTaskName, &Robot::scriptTask, 0 },
+    { controlTaskName, &Robot::controlTask, Config::CONTROL_INTERVAL },
+    { rangingTaskName, &Robot::rangingTask, Config::RANGING_INTERVAL },
+    { telemetryTaskName, &Robot::telemetryTask, 0 },
+    { blinkTaskName, &Robot::blinkTask, Config::BLINK_INTERVAL }
+  };
+
+  /**
+   * The tuning the robot ships with
+   */
+  template<class Config>
+  const RobotParameters Robot<Config>::defaultParameters = {
+    Config::MIN_DIST_TO_OBSTACLE, Config::FILTER_WINDOW, Config::MIN_TURN_TIME, Config::MAX_TURN_TIME, Config::SCAN_ARC, Config::RUN_TIME
+  };
+
+  /**
+   * Constructor.  Make sure that we initialize all the member variables
+   */
+  template<class Config>
+  Robot<Config>::Robot(Link *transport, const RobotParameters &parameters) : parameters(parameters), leftMotor(Config::LEFT_MOTOR_NUMBER), rightMotor(Config::RIGHT_MOTOR_NUMBER),
+                   sensors(Config::MIN_DIST_TO_OBSTACLE * 10),
+                   governor(Config::STOP_TIME_TO_COLLISION, Config::FULL_TIME_TO_COLLISION, Config::CRAWL_SPEED),
+                   odometry(Config::WHEEL_MAX_SPEED, Config::WHEEL_DEADBAND, Config::WHEEL_BASE),
+                   scanner(Config::SCAN_RANGE, Config::SIDE_TOLERANCE), calibration(Config::WHEEL_BASE, Config::SENSOR_OFFSET), remoteControl(transport), isLedOn(false),
+                   distance(Config::MIN_DIST_TO_OBSTACLE * 10), rawDistance(Config::MIN_DIST_TO_OBSTACLE * 10), link(transport), scheduler(this, tasks),
+                   speedControl(Config::LEFT_ENCODER_PIN, Config::RIGHT_ENCODER_PIN, Config::ENCODER_MAX_RATE, Config::ENCODER_SAMPLE_INTERVAL, Config::SPEED_CONTROL_INTERVAL),
+                   linkWatch(Config::LINK_TIMEOUT, Config::PROBE_INTERVAL), loopTime(0), lastCommand(RemoteControlCommand::controlCommand), idle(false), lastActive(0) {
+    initialize();
+  }
+
+  /**
+   * Destructor.  Nothing to do.
+   */
+  template<class Config>
+  Robot<Config>::~Robot(){
+
+  }
+
+  /**
+   * Initialize the robot.  This needs to run only once
+   */
+  template<class Config>
+  void Robot<Config>::initialize() {
+    randomSeed(analogRead(Config::RANDOM_ANALOG_PIN)); //for random number generation
+    leftMotor.setRampRate(Config::MOTOR_RAMP_RATE);
+    rightMotor.setRampRate(Config::MOTOR_RAMP_RATE);
+    speedControl.setGains(Config::SPEED_KP, Config::SPEED_KI, Config::SPEED_KD);
+    drive(0, 0);
+    controlByRemote();
+    pinMode(Config::LED_PIN, OUTPUT); //LED
+    sensors.setFilter(Filter(Config::MIN_DIST_TO_OBSTACLE * 10, parameters.filterWindow));
+    rangeFinders.attach(sensors);
+    sensors.begin(); //falls back to blocking pings if the echo pin cannot interrupt
+  }
+
+  /**
+   * Set up what needs the board running, from setup().  Paints the stack, unless that
+   * happened at reset already, loads the motor calibration and starts the speed control
+   */
+  template<class Config>
+  void Robot<Config>::begin() {
+    StackMonitor::begin();
+    loadCalibration();
+  }
+
+  /**
+   * Drive the motors through the speed to PWM tables in EEPROM if calibration has stored
+   * them, and have the odometry expect linear wheels.  Otherwise speeds go out as PWM.
+   * With wheel encoders the speeds are then held by the speed control, the tables only
+   * give it a better start, and a speed of 255 is ENCODER_MAX_RATE on both wheels
+   */
+  template<class Config>
+  void Robot<Config>::loadCalibration() {
+    unsigned int maxSpeed;
+    if (Calibrator::load(maxSpeed)) {
+      leftMotor.setTable(MotorCalibration::tableAddress(MotorCalibration::motorLeft));
+      rightMotor.setTable(MotorCalibration::tableAddress(MotorCalibration::motorRight));
+      odometry.setDriveTrain(maxSpeed, 0);
+    }
+    else {
+      leftMotor.setTable(MotorDriver::NO_TABLE);
+      rightMotor.setTable(MotorDriver::NO_TABLE);
+      odometry.setDriveTrain(Config::WHEEL_MAX_SPEED * 16, Config::WHEEL_DEADBAND);
+    }
+    if (speedControl.start(leftMotor, rightMotor))
+      odometry.setDriveTrain(Config::ENCODER_MAX_RATE * 1600UL / Config::ENCODER_TICKS_PER_METER, 0);
+  }
+
+  /**
+   * Measure the motors, see MotorCalibration.  They run open loop on raw PWM until it is over
+   */
+  template<class Config>
+  void Robot<Config>::startCalibration(unsigned long currentTime) {
+    speedControl.stop();
+    leftMotor.setTable(MotorDriver::NO_TABLE);
+    rightMotor.setTable(MotorDriver::NO_TABLE);
+    drive(0, 0);
+    calibration.start(currentTime);
+    currentState = stateCalibrating;
+  }
+
+  /**
+   * Run the motion script uploaded last, or report that it cannot run.  The script task
+   * takes over the motors, see scriptTask()
+   */
+  template<class Config>
+  void Robot<Config>::startScript() {
+    if (!script.start(micros())) {
+      script.report(*link);
+      return;
+    }
+    currentState = stateScripted;
+    scheduler.setPeriod(taskScript, Config::SCRIPT_INTERVAL);
+  }
+
+  /**
+   * Stop the script, and the robot, and go back to remote control
+   */
+  template<class Config>
+  void Robot<Config>::endScript() {
+    script.stop();
+    scheduler.setPeriod(taskScript, 0);
+    drive(0, 0);
+    controlByRemote();
+  }
+
+  /**
+   * Just set the state of the robot to remote
+   */
+  template<class Config>
+  void Robot<Config>::controlByRemote() {
+    currentState = stateRemote;
+  }
+
+  /**
+   * Start moving the robot forward and set state accordingly
+   */
+  template<class Config>
+  void Robot<Config>::move() {
+    governor.reset(); //closing speeds from before the turn mean nothing now
+    currentState = stateMoving;
+    cruise();
+  }
+
+  /**
+   * Stop the robot and set state accordingly
+   */
+  template<class Config>
+  void Robot<Config>::stop() {
+    drive(0, 0);
+    currentState = stateStopped;
+  }
+
+  /**
+   * Spins the robot in place by moving both motors in opposite directions
+   * toward the side with more room.  If the sides look the same, away from a side the map
+   * knows to be blocked, or a random side if it knows nothing either way.  With the centre
+   * sensor alone the sides always look the same.
+   * With a scan arc the robot looks around as it spins and then turns to the most open
+   * way it saw, see TurnScanner, for up to SCAN_TIMEOUT.  Otherwise
+   * turning continues for between 0.5 and 1 second (by default) chosen at random
+   */
+  template<class Config>
+  void Robot<Config>::turn(unsigned long currentTime, const Distances &distances) {
+    int leftRoom = distances.distance[SENSOR_LEFT];
+    int rightRoom = distances.distance[SENSOR_RIGHT];
+    bool left;
+    if (abs(leftRoom - rightRoom) >= Config::SIDE_TOLERANCE) {
+      left = leftRoom > rightRoom;
+    }
+    else {
+      bool leftBlocked = knownBlocked(90);
+      bool rightBlocked = knownBlocked(-90);
+      left = leftBlocked == rightBlocked ? Trace::random(0, 2) == 0 : rightBlocked;
+    }
+    spin(left);
+    currentState = stateTurning;
+    if (scanner.start(odometry.getHeading(), parameters.scanArc, left))
+      endStateTime = currentTime + Config::SCAN_TIMEOUT;
+    else
+      endStateTime = currentTime + Trace::random(parameters.minTurnTime, parameters.maxTurnTime);  
+  }
+
+  /**
+   * Spin in place at full speed, counter clockwise if left
+   */
+  template<class Config>
+  void Robot<Config>::spin(bool left) {
+    if (left) { //turn left
+      drive(-255, 255);
+    }
+    else { //turn right
+      drive(255, -255);
+    }
+  }
+
+  /**
+   * Switch to auto control.  endTime for autocontrol is set to 
+   * the run time (30 seconds by default) from now
+   */
+  template<class Config>
+  void Robot<Config>::switchToAutoControl(unsigned long currentTime) {
+    governor.reset();
+    currentState = stateMoving;
+    cruise();
+    endTime = currentTime + parameters.runTime * 1000UL;
+  }
+
+  /**
+   * Drive straight ahead as fast as the time to collision allows, full speed with the governor off
+   */
+  template<class Config>
+  void Robot<Config>::cruise() {
+    int speed = governor.scale(255);
+    drive(speed, speed);
+  }
+
+  /**
+   * If the moving average distance of any sensor from an obstacle is less than 10cm (by default) return true
+   * otherwise return false
+   */
+  template<class Config>
+  bool Robot<Config>::obstacleAhead(const Distances &distances) {
+    for (unsigned char i = 0; i < Config::NUM_SENSORS; i++) {
+      if (distances.distance[i] <= parameters.minDistance)
+        return true;
+    }
+    return false;
+  }
+
+  /**
+   * If the robot has done turning for 0.5 to 1 seconds (decided at random), or faces the
+   * way a scan chose,
+   * check to make sure that the robot is not going to crash into an obstacle.
+   * If there is an obstacle ahead continue to turn, and for up to another maximum turn
+   * time also while the map knows of one close ahead that the sensors have not seen yet
+   */
+  template<class Config>
+  bool Robot<Config>::doneTurning(unsigned long currentTime, const Distances &distances) {
+    if (scanner.isActive()) {
+      if (scanner.update(odometry.getHeading()) && currentTime < endStateTime) {
+        spin(scanner.isLeft());
+        return false;
+      }
+      scanner.stop();
+      endStateTime = currentTime; //dead reckoning may be off, what the sensors see now decides
+    }
+    if (currentTime < endStateTime || obstacleAhead(distances))
+      return false;
+    return currentTime >= endStateTime + parameters.maxTurnTime || !knownBlocked(0);
+  }
+
+  /**
+   * True if the map has an obstacle within DEAD_END_RANGE in the direction bearing degrees
+   * off the heading, counter clockwise
+   */
+  template<class Config>
+  bool Robot<Config>::knownBlocked(int bearing) {
+    return obstacles.isBlocked(odometry.getX(), odometry.getY(), odometry.getHeading() + binaryAngle(bearing),
+                               Config::DEAD_END_RANGE + Config::SENSOR_OFFSET);
+  }
+
+  /**
+   * Process the command receieved.  A command may answer on the link straight away, so the
+   * frame going out is finished first
+   */
+  template<class Config>
+  void Robot<Config>::processCommand(RemoteControlCommand &command, unsigned long currentTime) {
+    LinkQueue::finish(*link);
+    if (isCalibrating() && (command.getKeyType() == RemoteControlCommand::controlCommand ||
+                            command.getKeyType() == RemoteControlCommand::autoCommand ||
+                            command.getKeyType() == RemoteControlCommand::scriptCommand)) {
+      loadCalibration(); //cut short, back to the tables there were
+    }
+    if (isScripted() && (command.getKeyType() == RemoteControlCommand::controlCommand ||
+                         command.getKeyType() == RemoteControlCommand::autoCommand ||
+                         command.getKeyType() == RemoteControlCommand::moveCommand ||
+                         command.getKeyType() == RemoteControlCommand::calibrateCommand ||
+                         command.getKeyType() == RemoteControlCommand::uploadCommand)) {
+      endScript(); //taking over cuts the script short
+    }
+    if (command.getKeyType() == RemoteControlCommand::controlCommand) {
+      controlByRemote();
+      //Initialize speed to current speed
+      command.setLeftSpeed(leftMotor.getSpeed());
+      command.setRightSpeed(rightMotor.getSpeed());
+    }
+    else if (command.getKeyType() == RemoteControlCommand::autoCommand) {
+      switchToAutoControl(currentTime);
+    }
+    else if (command.getKeyType() == RemoteControlCommand::profileCommand) {
+  #ifdef PROFILING
+      profiler.report(*link);
+  #endif
+      scheduler.report(*link);
+      sensors.report(*link);
+      powerSaver.report(*link);
+    }
+    else if (command.getKeyType() == RemoteControlCommand::telemetryCommand) {
+      unsigned int period = command.getTelemetryPeriod();
+      if (period == TELEMETRY_TOGGLE)
+        period = scheduler.getPeriod(taskTelemetry) ? 0 : Config::TELEMETRY_INTERVAL;
+      telemetry.restart();
+      scheduler.setPeriod(taskTelemetry, period);
+    }
+    else if (command.getKeyType() == RemoteControlCommand::governorCommand) {
+      governor.setEnabled(!governor.isEnabled());
+      governor.reset();
+    }
+    else if (command.getKeyType() == RemoteControlCommand::poseCommand) {
+      reportPose();
+    }
+    else if (command.getKeyType() == RemoteControlCommand::calibrateCommand) {
+      startCalibration(currentTime);
+    }
+    else if (command.getKeyType() == RemoteControlCommand::memoryCommand) {
+      StackMonitor::report(*link);
+    }
+    else if (command.getKeyType() == RemoteControlCommand::wheelsCommand) {
+      speedControl.report(*link);
+    }
+    else if (command.getKeyType() == RemoteControlCommand::uploadCommand) {
+      script.load(remoteControl.getUpload(), remoteControl.getUploadLength());
+    }
+    else if (command.getKeyType() == RemoteControlCommand::scriptCommand) {
+      startScript();
+    }
+    else if (command.getKeyType() == RemoteControlCommand::linkCommand) {
+      linkWatch.report(*link);
+    }
+    else if (command.getKeyType() == RemoteControlCommand::watchdogCommand) {
+      linkWatch.setTimeout(command.getLinkTimeout());
+    }
+    else {
+      //do nothing
+    }
+  }
+
+  /**
+   * The robot is idle when it is at rest and stopped, or remote controlled with no command
+   * for IDLE_DELAY.  The sensors do not ping while idle, so the robot neither wastes power
+   * nor disturbs the sensors of other robots nearby, and run() sleeps between tasks
+   */
+  template<class Config>
+  void Robot<Config>::updateIdle(unsigned long currentTime) {
+    bool resting = leftMotor.getOutput() == 0 && rightMotor.getOutput() == 0;
+    bool nowIdle = resting && (isStopped() || (isRemoteControlled() && currentTime - lastActive >= Config::IDLE_DELAY));
+    if (nowIdle == idle)
+      return;
+    idle = nowIdle;
+    scheduler.setPeriod(taskRanging, idle ? 0 : Config::RANGING_INTERVAL);
+  }
+
+  /**
+   * Only listen as far as matters for what the robot is doing.  Spinning in place only the
+   * first metre counts, when moving the range grows with the speed, and when stopped or
+   * remote controlled the sensors see as far as they can
+   */
+  template<class Config>
+  void Robot<Config>::gateRange() {
+    unsigned int range = 0;
+    if (isTurning()) {
+      range = scanner.isScanning() ? Config::SCAN_RANGE : Config::TURNING_RANGE;
+    }
+    else if (isCalibrating()) {
+      range = Config::CALIBRATION_RANGE;
+    }
+    else if (isMoving()) {
+      int speed = (leftMotor.getOutput() + rightMotor.getOutput()) / 2;
+      range = Config::MIN_MOVING_RANGE + (speed > 0 ? speed : 0);
+    }
+    sensors.setMaxDistance(range);
+  }
+
+  /**
+   * Queue the dead reckoned pose as a FRAME_POSE frame
+   */
+  template<class Config>
+  void Robot<Config>::reportPose() {
+    unsigned char payload[6];
+    unsigned char frame[sizeof(payload) + FRAME_OVERHEAD];
+    writeInt16(payload, odometry.getX());
+    writeInt16(payload + 2, odometry.getY());
+    writeInt16(payload + 4, (int)odometry.getHeading());
+    LinkQueue::put(frame, encodeFrame(frame, FRAME_POSE, payload, sizeof(payload)));
+  }
+
+  /**
+   * Check if done running in automode (i.e. robot has been in automode for its run time or more)
+   */
+  template<class Config>
+  bool Robot<Config>::doneRunning(unsigned long currentTime) {
+    return (currentTime >= endTime);
+  }
+
+  /**
+   * This method runs during every loop() of the Arduino sketch
+   * Runs whichever tasks are due, and sends telemetry, trace and log output in the time left over.
+   * While idle it sleeps until the next interrupt, which is not counted as part of the pass
+   */
+  template<class Config>
+  void Robot<Config>::run() {
+    PROFILE_BEGIN();
+    unsigned long passStart = micros();
+    scheduler.run();
+    LinkQueue::drain(*link);
+    PROFILE_MARK(stageTelemetry);
+    Logger::drain();
+    PROFILE_MARK(stageLog);
+    PROFILE_END();
+    unsigned long passTime = micros() - passStart;
+    if (passTime > loopTime)
+      loopTime = passTime > 0xFFFF ? 0xFFFF : passTime;
+    if (idle)
+      powerSaver.sleep(scheduler.nextRelease());
+  }
+
+  /**
+   * Ranging task.  Collects the latest echo and fires the next sensor
+   */
+  template<class Config>
+  void Robot<Config>::rangingTask(unsigned long /*currentTime*/) {
+    int fresh = sensors.update(micros());
+    if (fresh >= 0)
+      useSample(fresh);
+    PROFILE_MARK(stageSensing);
+  }
+
+  /**
+   * Feed a sample taken elsewhere, e.g. replayed from a trace, in place of the sensors
+   */
+  template<class Config>
+  void Robot<Config>::replaySample(unsigned char index, unsigned int cm, bool echo, unsigned long time) {
+    sensors.add(index, cm, echo, time);
+    useSample(index);
+  }
+
+  /**
+   * Act on the newest sample of sensor index, which the sensor array has averaged already
+   */
+  template<class Config>
+  void Robot<Config>::useSample(unsigned char index) {
+    const Distances &distances = sensors.getVector();
+    Trace::sample(index, distances.raw[index], distances.echo[index], distances.time[index]);
+    governor.update(index, distances.raw[index], distances.echo[index], distances.time[index]);
+    int bearing = index == SENSOR_CENTER ? 0 : (index == SENSOR_LEFT ? Config::SIDE_SENSOR_ANGLE : -Config::SIDE_SENSOR_ANGLE);
+    obstacles.update(odometry.getX(), odometry.getY(), odometry.getHeading() + binaryAngle(bearing),
+                     distances.raw[index] + Config::SENSOR_OFFSET, distances.echo[index]);
+    if (isTurning())
+      scanner.add(odometry.getHeading() + binaryAngle(bearing), distances.raw[index], distances.echo[index]);
+    if (isCalibrating())
+      calibration.add(index, distances.raw[index], distances.echo[index], distances.time[index]);
+    if (index == SENSOR_CENTER) {
+      rawDistance = distances.raw[SENSOR_CENTER];
+      distance = distances.distance[SENSOR_CENTER];
+    }
+  }
+
+  /**
+   * Control task.  Acts on remote control commands, watches the link, makes the decisions
+   * in auto mode and ramps the motors
+   */
+  template<class Config>
+  void Robot<Config>::controlTask(unsigned long currentTime) {
+    RemoteControlCommand command;
+    Trace::control(currentTime);
+    bool haveCommand = remoteControl.receiveAndParseCommand(currentTime);
+    PROFILE_MARK(stageReceive);
+
+    if (haveCommand) {
+      command = remoteControl.getCommand();
+      lastCommand = command.getKeyType();
+      lastActive = currentTime;
+      processCommand(command, currentTime);
+      PROFILE_MARK(stageProcess);
+      //Logger outputs to serial terminal only if LOGGING is defined
+      Logger::log(Logger::logCommand, currentState, rawDistance, command.getKeyType());
+      PROFILE_MARK(stageLog);
+    }
+    linkWatch.update(remoteControl, *link, currentTime);
+
+    //dead reckon over the last period, then ramp the motors toward the speeds set on earlier passes
+    PROFILE_START(rampStart);
+    odometry.update(leftMotor.getOutput(), rightMotor.getOutput(), currentTime);
+    leftMotor.update(currentTime);
+    rightMotor.update(currentTime);
+    PROFILE_SECTION(stageMotors, rampStart);
+
+    if(isRemoteControlled()) { //Manual or Remote control mode
+      if (haveCommand) { //only if a button is pressed
+        //Logger outputs to serial terminal only if LOGGING is defined
+        Logger::log(Logger::logMotorCommand, command.getKeyType(), command.getLeftSpeed(), command.getRightSpeed());
+        PROFILE_MARK(stageLog);
+        drive(command.getLeftSpeed(), command.getRightSpeed());
+      }
+      else if (linkWatch.isLost(currentTime) && (leftMotor.getSpeed() != 0 || rightMotor.getSpeed() != 0)) {
+        //the remote is gone, do not drive on with its last command
+        drive(0, 0);
+        remoteControl.stop();
+        linkWatch.trip();
+      }
+    }
+    else if (isCalibrating()) {
+      int left, right;
+      if (calibration.update(currentTime, left, right) == MotorCalibration::resultRunning) {
+        drive(left, right);
+      }
+      else {
+        LinkQueue::finish(*link);
+        calibration.report(*link);
+        loadCalibration();
+        drive(0, 0);
+        controlByRemote();
+      }
+    }
+    else if (isScripted()) {
+      //the script task drives
+    }
+    else if (!isStopped()) { //Auto mode
+      if (doneRunning(currentTime)) {
+        stop();
+      }
+      else if (isMoving()) {
+        if (obstacleAhead(sensors.getVector()))
+          turn(currentTime, sensors.getVector());
+        else
+          cruise();
+      }
+      else if (isTurning()) {
+        if (doneTurning(currentTime, sensors.getVector()))
+          move();
+      }
+    }
+    updateIdle(currentTime);
+    gateRange();
+    Trace::outputs(currentState, leftMotor.getOutput(), rightMotor.getOutput());
+    PROFILE_MARK(stageDecision);
+  }
+
+  /**
+   * Script task.  Runs the motion script's instructions that are due and ramps the motors
+   * as often as it runs, so that a segment starts within a period of when it should.
+   * When the script is over it reports how precisely it ran and hands back to remote control
+   */
+  template<class Config>
+  void Robot<Config>::scriptTask(unsigned long currentTime) {
+    int left, right;
+    if (script.step(micros(), distance, left, right) == MotionScript::resultRunning) {
+      drive(left, right);
+      leftMotor.update(currentTime);
+      rightMotor.update(currentTime);
+    }
+    else {
+      LinkQueue::finish(*link);
+      script.report(*link);
+      endScript();
+    }
+  }
+
+  /**
+   * Telemetry task.  Queues a sample of the state, raw and averaged distance, both motor
+   * speeds, the longest loop pass since the previous sample and the last command
+   */
+  template<class Config>
+  void Robot<Config>::telemetryTask(unsigned long currentTime) {
+    long fields[Telemetry::numFields];
+    fields[Telemetry::fieldState] = currentState;
+    fields[Telemetry::fieldRawDistance] = rawDistance;
+    fields[Telemetry::fieldDistance] = distance;
+    fields[Telemetry::fieldLeftSpeed] = leftMotor.getSpeed();
+    fields[Telemetry::fieldRightSpeed] = rightMotor.getSpeed();
+    fields[Telemetry::fieldLoopTime] = loopTime;
+    fields[Telemetry::fieldCommand] = lastCommand;
+    telemetry.send(currentTime, fields);
+    loopTime = 0;
+    PROFILE_MARK(stageTelemetry);
+  }
+
+  /**
+   * Blink task.  Just makes an LED blink at regular intervals
+   */
+  template<class Config>
+  void Robot<Config>::blinkTask(unsigned long /*currentTime*/) {
+    if (isLedOn) {
+      digitalWrite(Config::LED_PIN, LOW);
+      isLedOn = false;
+    }
+    else {
+      digitalWrite(Config::LED_PIN, HIGH);
+      isLedOn = true;
+    }
+    PROFILE_MARK(stageBlink);
+  }
+
+  /**
+   * Set the speed of both motors.  With ramping on, run() gets them there
+   */
+  template<class Config>
+  void Robot<Config>::drive(int leftSpeed, int rightSpeed) {
+    PROFILE_START(motorStart);
+    leftMotor.setSpeed(leftSpeed);
+    rightMotor.setSpeed(rightSpeed);
+    PROFILE_SECTION(stageMotors, motorStart);
+  }
+
 }
 
-#endif
+#endif
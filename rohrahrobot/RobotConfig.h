@@ -0,0 +1,194 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _ROBOT_CONFIG_H_
+#define _ROBOT_CONFIG_H_
+
+#include "Transport.h"
+#include "Motor.h"
+#include "MovingAverage.h"
+#include "MedianFilter.h"
+#include "ExponentialMovingAverage.h"
+#include "SpeedGovernor.h"
+#include "MotorCalibration.h"
+#include "OccupancyGrid.h"
+#include "Telemetry.h"
+#include "WheelSpeedControl.h"
+#include "MotionScript.h"
+#include "LinkMonitor.h"
+
+namespace rohrah {
+
+  /**
+   * What a Robot is built from and with, all known at compile time: pins, motor numbers,
+   * thresholds, task periods and the types of its components.  Robot<StandardConfig> is
+   * the robot as wired up and shipped.
+   *
+   * A variant derives from a config and overrides what differs.  A component swapped for
+   * its No... stand-in, e.g. NoOccupancyGrid, compiles out, code and RAM alike.
+   */
+  struct StandardConfig {
+    // constants
+    static constexpr unsigned int MIN_DIST_TO_OBSTACLE = 10; //10cm
+    static constexpr unsigned int MAX_DISTANCE_TO_TRACK = MIN_DIST_TO_OBSTACLE * 60; //600cm
+    static constexpr int SIDE_TOLERANCE = 20; //cm, sides closer than this to each other count as the same
+    static constexpr unsigned int TURNING_RANGE = 100; //cm the sensors listen for while spinning in place
+    static constexpr unsigned char SCAN_RANGE = 200; //cm the sensors listen for while a turn scans, at most 254
+    static constexpr unsigned int CALIBRATION_RANGE = 300; //cm the sensors listen for while calibrating, the side sensors see the wall far off at an angle
+    static constexpr unsigned int MIN_MOVING_RANGE = 50; //cm the sensors listen for when crawling, plus 1cm per unit of speed
+    static constexpr unsigned int STOP_TIME_TO_COLLISION = 500; //ms, the governor is down to CRAWL_SPEED when an obstacle is this close in time
+    static constexpr unsigned int FULL_TIME_TO_COLLISION = 1500; //ms, and lets the robot go full speed from here
+    static constexpr int CRAWL_SPEED = 100; //slowest governed speed, safely above where the motors stall
+    static constexpr unsigned int DEAD_END_RANGE = 60; //cm, a turn does not end facing an obstacle the map knows of this close
+    static constexpr unsigned int IDLE_DELAY = 1000; //ms without a command before a robot at rest under remote control goes idle
+    static constexpr unsigned char SENSOR_OFFSET = 10; //cm from the middle of the robot to the sensors
+    static constexpr int SIDE_SENSOR_ANGLE = 30; //degrees the side sensors look off the heading
+
+    // run time in seconds when in auto mode
+    static constexpr unsigned int RUN_TIME = 30;
+
+    // how long a turn lasts, chosen at random, in ms
+    static constexpr unsigned int MIN_TURN_TIME = 500;
+    static constexpr unsigned int MAX_TURN_TIME = 1000;
+
+    // degrees a turn scans through before it turns to the most open way, 0 for turns of random length
+    static constexpr unsigned int SCAN_ARC = 90; //from sweep --scatter, a full turn costs more time than it finds room
+    static constexpr unsigned int SCAN_TIMEOUT = 3000; //ms, a scanning turn that takes longer ends as a timed one does
+
+    // drive train, for dead reckoning
+    static constexpr unsigned int WHEEL_MAX_SPEED = 60; //cm/s at full PWM
+    static constexpr unsigned char WHEEL_DEADBAND = 70; //PWM below which the wheels do not turn
+    static constexpr unsigned char WHEEL_BASE = 14; //cm between the wheels
+
+    // task periods in ms
+    static constexpr unsigned long CONTROL_INTERVAL = 20; //50Hz
+    static constexpr unsigned long RANGING_INTERVAL = 10; //100Hz, the sensors take turns as fast as their ranges allow
+    static constexpr unsigned long BLINK_INTERVAL = 2000; //0.5Hz
+    static constexpr unsigned int TELEMETRY_INTERVAL = 100; //once switched on with 'T', FRAME_TELEMETRY sets any other
+    static constexpr unsigned long SCRIPT_INTERVAL = 1; //1kHz while a motion script runs
+    static constexpr unsigned int PROBE_INTERVAL = 200; //ms between link probes, once the remote pings
+    static constexpr unsigned int LINK_TIMEOUT = 600; //ms without a frame before a robot under remote control stops, FRAME_WATCHDOG sets any other
+
+    //pins on motor shield
+    static constexpr int LEFT_MOTOR_NUMBER = 1;
+    static constexpr int RIGHT_MOTOR_NUMBER = 4;
+    static constexpr unsigned char MOTOR_RAMP_RATE = 2; //counts per ms, full speed in about 130ms.  0 to switch ramping off
+
+    // wheel encoders and closed loop speed control, Timer1 samples the encoders
+    static constexpr unsigned int ENCODER_TICKS_PER_METER = 196; //both edges of a 20 slot disk on a 65mm wheel
+    static constexpr unsigned int ENCODER_MAX_RATE = 90; //ticks/s at speed 255, 46cm/s, short of what a wheel does at full PWM to leave room to correct
+    static constexpr unsigned int ENCODER_SAMPLE_INTERVAL = 1000; //us, 1kHz
+    static constexpr unsigned int SPEED_CONTROL_INTERVAL = 20; //ms, 50Hz
+    static constexpr int SPEED_KP = 64; //Q8 gains of the speed PID, from speed_bench --tune
+    static constexpr int SPEED_KI = 128;
+    static constexpr int SPEED_KD = 0;
+
+    //pins on arduino
+    static constexpr int RANDOM_ANALOG_PIN = 5; //unconnected pin for random input
+    static constexpr int ECHO_PIN = 2; //external interrupt INT0, the echo is timed asynchronously.  All echo lines go here through diodes
+    static constexpr int TRIGGER_PIN = 15; //pin A1, center sensor
+    static constexpr int LEFT_TRIGGER_PIN = 9; //servo 2 header on the motor shield
+    static constexpr int RIGHT_TRIGGER_PIN = 10; //servo 1 header on the motor shield
+    static constexpr int LED_PIN = 13; //for the blinking LED
+    static constexpr int BT_RX_PIN = 16; //pin A3, the Bluetooth module on SoftwareSerial
+    static constexpr int BT_TX_PIN = 17; //pin A4
+    static constexpr int LEFT_ENCODER_PIN = 14; //pin A0
+    static constexpr int RIGHT_ENCODER_PIN = 18; //the analog pin after the Bluetooth module's
+
+    // components
+    static constexpr unsigned char NUM_SENSORS = 3; //left, centre and right, or 1 for the centre sensor alone
+    static constexpr unsigned char FILTER_WINDOW = 8; //a power of two, so averaging is a shift
+    static constexpr unsigned char SCRIPT_SIZE = 64; //bytes of motion script, a drive segment takes 7
+
+    /**
+     * Filter for the distance readings, constructed from the distance to start at and the
+     * window (RobotParameters::filterWindow).  MovingAverage with a smaller N takes less RAM
+     * per sensor.  MedianFilter takes the same window and rejects single bad echoes, but
+     * keeps the window twice and sorts it; ExponentialMovingAverage ignores the window,
+     * needs only its sum and reacts fastest, see filter_bench for what each costs
+     */
+    typedef MovingAverage<unsigned int, FILTER_WINDOW> Filter;
+    typedef Motor MotorDriver;
+    typedef Transport Link; //what the robot talks to the remote control over
+    typedef SpeedGovernor<NUM_SENSORS> Governor;
+    typedef OccupancyGrid<32, 4> Map; //32 x 32 cells of 16cm around the start, 256 bytes
+    typedef MotorCalibration Calibrator;
+    typedef Telemetry Telemeter;
+    typedef WheelSpeedControl SpeedControl;
+    typedef MotionProgram<SCRIPT_SIZE> Script;
+    typedef LinkMonitor LinkWatch;
+  };
+
+  /**
+   * The three sensor robot without the extras: no map, no motor calibration, no
+   * telemetry, no wheel encoders, no motion scripts and no link monitor.  Turns pick a side
+   * by the sensors alone
+   */
+  struct LeanConfig : StandardConfig {
+    typedef NoOccupancyGrid Map;
+    typedef NoMotorCalibration Calibrator;
+    typedef NoTelemetry Telemeter;
+    typedef NoWheelSpeedControl SpeedControl;
+    typedef NoMotionProgram Script;
+    typedef NoLinkMonitor LinkWatch;
+  };
+
+  /**
+   * The robot as it started out: the centre sensor alone, averaged over 4 samples, full
+   * speed until something is close and a turn to a random side
+   */
+  struct BasicConfig : LeanConfig {
+    static constexpr unsigned char NUM_SENSORS = 1;
+    static constexpr unsigned char FILTER_WINDOW = 4;
+    typedef MovingAverage<unsigned int, FILTER_WINDOW> Filter;
+    typedef NoSpeedGovernor Governor;
+  };
+
+  /**
+   * The standard robot with the median of the last 5 samples of each sensor, which a single
+   * missed or stray echo does not move
+   */
+  struct MedianConfig : StandardConfig {
+    static constexpr unsigned char FILTER_WINDOW = 5; //odd, for a true median
+    typedef MedianFilter<unsigned int, FILTER_WINDOW> Filter;
+  };
+
+  /**
+   * The standard robot with an exponential moving average of each sensor, which keeps no
+   * window and follows an obstacle closing in soonest
+   */
+  struct ExponentialConfig : StandardConfig {
+    typedef ExponentialMovingAverage<unsigned int, 2> Filter;
+  };
+}
+
+#endif
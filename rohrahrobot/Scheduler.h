@@ -0,0 +1,230 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Cooperative fixed rate scheduler over a static table of tasks.
+   * A task is a member function of OWNER that gets the current time in ms, and runs to
+   * completion.  Each task is released every period and its deadline is its next release.
+   * The table order is the priority: tasks that are due on the same pass run in table order.
+   * A task that falls a whole period behind skips the releases it missed instead of
+   * running back to back to catch up.
+   *
+   * Per task the scheduler counts runs and deadline overruns and keeps the longest run
+   * time and the smallest slack, which is how much time was left before the deadline
+   * when the task finished.  It also adds up the time spent in tasks, to report how
+   * busy the CPU is.
+   */
+  template<class OWNER, unsigned char N>
+  class Scheduler {
+    public:
+      typedef void (OWNER::*method_t)(unsigned long currentTime);
+
+      struct Task {
+        const char *name; //in PROGMEM
+        method_t method;
+        unsigned long period; //ms, 0 for a task that only runs once setPeriod() enables it
+      };
+
+      Scheduler(OWNER *owner, const Task *table);
+      bool run();
+      void setPeriod(unsigned char task, unsigned long periodMs);
+      unsigned long getPeriod(unsigned char task) const { return state[task].period / 1000; }
+      unsigned long nextRelease() const;
+      void report(Print &out);
+      void reset();
+
+    private:
+      struct State {
+        unsigned long period; //us
+        unsigned long release; //us, when the task is next due
+        unsigned long runs;
+        unsigned int overruns;
+        unsigned int maxTime; //us
+        long minSlack; //us
+      };
+
+      void start();
+
+      OWNER *owner;
+      const Task *tasks;
+      State state[N];
+      bool started;
+      unsigned long busyTime; //us spent in tasks since the last reset
+      unsigned long resetTime;
+  };
+
+  /**
+   * Constructor
+   * Nothing is timed until the first run(), global objects are built before the clock starts
+   */
+  template<class OWNER, unsigned char N>
+  Scheduler<OWNER, N>::Scheduler(OWNER *owner, const Task *table): owner(owner), tasks(table), started(false) {
+    for (unsigned char i = 0; i < N; i++)
+      state[i].period = tasks[i].period * 1000;
+    reset();
+  }
+
+  /**
+   * Release every enabled task now
+   */
+  template<class OWNER, unsigned char N>
+  void Scheduler<OWNER, N>::start() {
+    unsigned long now = micros();
+    for (unsigned char i = 0; i < N; i++)
+      state[i].release = now;
+    resetTime = now;
+    started = true;
+  }
+
+  /**
+   * Run every task that is due, highest priority first.
+   * Returns true if anything ran
+   */
+  template<class OWNER, unsigned char N>
+  bool Scheduler<OWNER, N>::run() {
+    if (!started)
+      start();
+    bool ran = false;
+    for (unsigned char i = 0; i < N; i++) {
+      State &s = state[i];
+      if (s.period == 0)
+        continue;
+      unsigned long startTime = micros();
+      if ((long)(startTime - s.release) < 0)
+        continue;
+
+      (owner->*tasks[i].method)(millis());
+
+      unsigned long endTime = micros();
+      //a task that printed the report is left out of the window it started
+      if ((long)(resetTime - startTime) <= 0) {
+        unsigned long elapsed = endTime - startTime;
+        busyTime += elapsed;
+        if (elapsed > s.maxTime)
+          s.maxTime = elapsed > 0xFFFF ? 0xFFFF : elapsed;
+        long slack = (long)(s.release + s.period - endTime);
+        if (slack < s.minSlack)
+          s.minSlack = slack;
+        if (slack < 0 && s.overruns != 0xFFFF)
+          s.overruns++;
+        s.runs++;
+      }
+
+      ran = true;
+      if (s.period == 0) //the task stopped itself
+        continue;
+      s.release += s.period;
+      if ((long)(endTime - s.release) >= 0) //a whole period behind
+        s.release += ((endTime - s.release) / s.period + 1) * s.period;
+    }
+    return ran;
+  }
+
+  /**
+   * Change how often a task runs.  A task given a period is due straight away,
+   * a period of 0 stops it
+   */
+  template<class OWNER, unsigned char N>
+  void Scheduler<OWNER, N>::setPeriod(unsigned char task, unsigned long periodMs) {
+    state[task].period = periodMs * 1000;
+    state[task].release = micros();
+  }
+
+  /**
+   * When the next enabled task is due, in micros().  Before the first run() that is now
+   */
+  template<class OWNER, unsigned char N>
+  unsigned long Scheduler<OWNER, N>::nextRelease() const {
+    unsigned long now = micros();
+    if (!started)
+      return now;
+    unsigned long next = now + 0x7FFFFFFFUL;
+    for (unsigned char i = 0; i < N; i++) {
+      if (state[i].period != 0 && (long)(state[i].release - next) < 0)
+        next = state[i].release;
+    }
+    return next;
+  }
+
+  /**
+   * Forget the statistics gathered so far
+   */
+  template<class OWNER, unsigned char N>
+  void Scheduler<OWNER, N>::reset() {
+    for (unsigned char i = 0; i < N; i++) {
+      state[i].runs = 0;
+      state[i].overruns = 0;
+      state[i].maxTime = 0;
+      state[i].minSlack = 0x7FFFFFFFL;
+    }
+    busyTime = 0;
+    resetTime = micros();
+  }
+
+  /**
+   * Print one line per task: name, period in ms, runs, overruns, longest run and smallest
+   * slack in us, then the share of the time since the last report spent in tasks.
+   * Starts a new reporting window
+   */
+  template<class OWNER, unsigned char N>
+  void Scheduler<OWNER, N>::report(Print &out) {
+    out.println(F("task period runs overruns max slack"));
+    for (unsigned char i = 0; i < N; i++) {
+      State &s = state[i];
+      out.print((const __FlashStringHelper *)tasks[i].name);
+      out.print(' ');
+      out.print(s.period / 1000);
+      out.print(' ');
+      out.print(s.runs);
+      out.print(' ');
+      out.print(s.overruns);
+      out.print(' ');
+      out.print(s.maxTime);
+      out.print(' ');
+      out.println(s.runs ? s.minSlack : 0);
+    }
+    unsigned long window = micros() - resetTime;
+    out.print(F("busy "));
+    out.print(busyTime / (window / 100 + 1));
+    out.println('%');
+    reset();
+  }
+}
+
+#endif
@@ -0,0 +1,214 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _SENSOR_ARRAY_H_
+#define _SENSOR_ARRAY_H_
+
+#include <Arduino.h>
+#include "DistanceSensor.h"
+
+namespace rohrah {
+
+  /**
+   * Latest readings of every sensor in an array, in cm.  distance is filtered, raw is
+   * the last sample, echo is false if that saw nothing within range, and time is when
+   * it was taken (micros())
+   */
+  template <unsigned char N>
+  struct DistanceVector {
+    unsigned int distance[N];
+    unsigned int raw[N];
+    bool echo[N];
+    unsigned long time[N];
+  };
+
+  /**
+   * N ultrasonic sensors that take turns.
+   * Only one sensor pings at a time, which lets all of them share one echo interrupt pin
+   * (the echo lines ORed together through diodes).  The next sensor fires as soon as the
+   * previous ping is done and its burst has had the previous sensor's full listening time
+   * to die out, so a late reflection of one sensor's burst is never taken for an echo of
+   * the next one.  That keeps the sensors free of crosstalk at the highest combined rate
+   * their ranges allow.
+   *
+   * Each sensor feeds its own FILTER (see MovingAverage.h), and the results are kept in
+   * a DistanceVector.  Sensors that could not start asynchronous ranging are pinged one
+   * per update(), blocking.
+   *
+   * setMaxDistance() gates the range of every sensor.  A shorter range shortens both the
+   * wait for a missing echo and the spacing between sensors, so the array samples faster.
+   * report() shows what that saved: the mean time from firing a ping to its sample, and the
+   * mean listening window against the one at full range.
+   */
+  template <unsigned char N, class FILTER>
+  class SensorArray {
+    public:
+      SensorArray(unsigned int defaultDistance);
+      void attach(unsigned char index, DistanceSensor *sensor) { sensors[index] = sensor; }
+      bool begin();
+      int update(unsigned long currentMicros);
+      const DistanceVector<N> &getVector() const { return vector; }
+      void setMaxDistance(unsigned int cm);
+      void report(Print &out);
+      void add(unsigned char index, unsigned int cm, bool echo, unsigned long time);
+      void setFilter(const FILTER &filter);
+
+    private:
+      DistanceSensor *sensors[N];
+      FILTER filters[N];
+      DistanceVector<N> vector;
+      unsigned char current; //the sensor whose turn it is
+      unsigned long lastPing;
+      unsigned long spacing; //us the next ping has to wait after the last one
+      unsigned long durationSum; //us from firing to the sample, over the pings since the last report
+      unsigned long windowSum; //us the same pings listened for at most
+      unsigned int pings;
+  };
+
+  /**
+   * Constructor
+   * Every sensor reads defaultDistance until it has samples of its own
+   */
+  template <unsigned char N, class FILTER>
+  SensorArray<N, FILTER>::SensorArray(unsigned int defaultDistance): current(0), lastPing(0), spacing(0),
+                                                                      durationSum(0), windowSum(0), pings(0) {
+    for (unsigned char i = 0; i < N; i++) {
+      sensors[i] = 0;
+      filters[i] = FILTER(defaultDistance);
+      vector.distance[i] = defaultDistance;
+      vector.raw[i] = defaultDistance;
+      vector.echo[i] = false;
+      vector.time[i] = 0;
+    }
+  }
+
+  /**
+   * Start every sensor's filter over as a copy of filter, e.g. one with a different window
+   */
+  template <unsigned char N, class FILTER>
+  void SensorArray<N, FILTER>::setFilter(const FILTER &filter) {
+    for (unsigned char i = 0; i < N; i++)
+      filters[i] = filter;
+  }
+
+  /**
+   * Start asynchronous ranging on every sensor.  Returns false if any of them has to block
+   */
+  template <unsigned char N, class FILTER>
+  bool SensorArray<N, FILTER>::begin() {
+    bool async = true;
+    for (unsigned char i = 0; i < N; i++)
+      async = sensors[i]->beginAsync() && async;
+    return async;
+  }
+
+  /**
+   * Call often, ideally more often than the shortest sensor timeout.
+   * Collects the ping in flight and fires the next sensor in turn when it may.
+   * Returns the index of the sensor that has a new sample, or -1
+   */
+  template <unsigned char N, class FILTER>
+  int SensorArray<N, FILTER>::update(unsigned long currentMicros) {
+    DistanceSensor *sensor = sensors[current];
+    int fresh = -1;
+    if (!sensor->isAsync()) {
+      unsigned int cm = sensor->getDistance();
+      add(current, cm, sensor->hasEcho(), micros());
+      fresh = current;
+      current = current + 1 < N ? current + 1 : 0;
+      return fresh;
+    }
+    if (sensor->isPinging()) {
+      if (!sensor->collect(currentMicros))
+        return -1;
+      add(current, sensor->getDistance(), sensor->hasEcho(), sensor->getSampleTime());
+      fresh = current;
+      if (pings == 0xFFFF) {
+        durationSum >>= 1;
+        windowSum >>= 1;
+        pings >>= 1;
+      }
+      durationSum += currentMicros - lastPing;
+      windowSum += spacing;
+      pings++;
+      current = current + 1 < N ? current + 1 : 0;
+      sensor = sensors[current];
+    }
+    if (currentMicros - lastPing >= spacing && sensor->startPing(currentMicros)) {
+      lastPing = currentMicros;
+      spacing = sensor->getTimeout();
+    }
+    return fresh;
+  }
+
+  /**
+   * Gate the range of every sensor at cm, or their full range for 0
+   */
+  template <unsigned char N, class FILTER>
+  void SensorArray<N, FILTER>::setMaxDistance(unsigned int cm) {
+    for (unsigned char i = 0; i < N; i++)
+      sensors[i]->setMaxDistance(cm);
+  }
+
+  /**
+   * Print the number of pings since the last report, the mean time from firing to the
+   * sample and the mean listening window, then the window at full range, all in us
+   */
+  template <unsigned char N, class FILTER>
+  void SensorArray<N, FILTER>::report(Print &out) {
+    out.println(F("pings mean window full"));
+    out.print(pings);
+    out.print(' ');
+    out.print(pings ? durationSum / pings : 0);
+    out.print(' ');
+    out.print(pings ? windowSum / pings : 0);
+    out.print(' ');
+    out.println(DistanceSensor::timeoutFor(sensors[0]->getMaxRange()));
+    durationSum = 0;
+    windowSum = 0;
+    pings = 0;
+  }
+
+  /**
+   * Put a new sample into the vector and the sensor's filter.  update() does this with
+   * every sample it collects
+   */
+  template <unsigned char N, class FILTER>
+  void SensorArray<N, FILTER>::add(unsigned char index, unsigned int cm, bool echo, unsigned long time) {
+    vector.raw[index] = cm;
+    vector.echo[index] = echo;
+    vector.distance[index] = filters[index].add(cm);
+    vector.time[index] = time;
+  }
+}
+
+#endif
@@ -0,0 +1,184 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _SPEED_GOVERNOR_H_
+#define _SPEED_GOVERNOR_H_
+
+namespace rohrah {
+
+  /**
+   * Time to collision speed governor for N distance sensors.
+   * Successive samples of each sensor give its closing speed, smoothed and kept in cm/s
+   * with 4 fractional bits, and its time to collision, distance over closing speed, in ms.
+   * The shortest time to collision sets the speed factor: full speed at fullTime or more,
+   * falling linearly to minSpeed at stopTime.  Slowing down stretches the time to collision
+   * again, so the robot closes in on an obstacle at a speed that shrinks with the distance
+   * and brakes earlier the more is around it.  The governor never stops the robot, that is
+   * left to the obstacle check.
+   *
+   * All integer arithmetic, no divisions by zero: a sensor without an echo, or without a
+   * recent previous sample, has no time to collision.
+   */
+  template <unsigned char N>
+  class SpeedGovernor {
+    public:
+      static const unsigned int NO_COLLISION = 0xFFFF;
+      static const unsigned int FULL_FACTOR = 256;
+
+      SpeedGovernor(unsigned int stopTime, unsigned int fullTime, int minSpeed);
+      void update(unsigned char index, unsigned int cm, bool echo, unsigned long sampleMicros);
+      int scale(int speed) const;
+      unsigned int getFactor() const;
+      unsigned int getTimeToCollision() const;
+      void reset();
+      void setEnabled(bool on) { enabled = on; }
+      bool isEnabled() const { return enabled; }
+
+    private:
+      static const unsigned long MAX_SAMPLE_GAP = 500000; //us, older samples are no use for a speed
+
+      unsigned int stopTime; //ms
+      unsigned int fullTime; //ms
+      int minSpeed;
+      bool enabled;
+      unsigned int lastCm[N];
+      unsigned long lastTime[N]; //0 for no previous sample
+      long closing[N]; //cm/s << 4, positive when getting closer
+      unsigned int timeToCollision[N]; //ms
+  };
+
+  /**
+   * Stands in for a SpeedGovernor in a robot built without one: always full speed
+   */
+  class NoSpeedGovernor {
+    public:
+      NoSpeedGovernor(unsigned int /*stopTime*/, unsigned int /*fullTime*/, int /*minSpeed*/) {}
+      void update(unsigned char /*index*/, unsigned int /*cm*/, bool /*echo*/, unsigned long /*sampleMicros*/) {}
+      int scale(int speed) const { return speed; }
+      void reset() {}
+      void setEnabled(bool /*on*/) {}
+      bool isEnabled() const { return false; }
+  };
+
+  /**
+   * Constructor
+   * Full speed while every time to collision is fullTime ms or more, minSpeed at stopTime ms
+   */
+  template <unsigned char N>
+  SpeedGovernor<N>::SpeedGovernor(unsigned int stopTime, unsigned int fullTime, int minSpeed):
+      stopTime(stopTime), fullTime(fullTime), minSpeed(minSpeed), enabled(true) {
+    reset();
+  }
+
+  /**
+   * Forget the history, e.g. after the robot turned
+   */
+  template <unsigned char N>
+  void SpeedGovernor<N>::reset() {
+    for (unsigned char i = 0; i < N; i++) {
+      lastCm[i] = 0;
+      lastTime[i] = 0;
+      closing[i] = 0;
+      timeToCollision[i] = NO_COLLISION;
+    }
+  }
+
+  /**
+   * A new sample from sensor index
+   */
+  template <unsigned char N>
+  void SpeedGovernor<N>::update(unsigned char index, unsigned int cm, bool echo, unsigned long sampleMicros) {
+    if (!echo) {
+      lastTime[index] = 0;
+      closing[index] = 0;
+      timeToCollision[index] = NO_COLLISION;
+      return;
+    }
+    unsigned long dt = sampleMicros - lastTime[index];
+    if (lastTime[index] != 0 && dt >= 1000 && dt < MAX_SAMPLE_GAP) {
+      long speed = ((long)lastCm[index] - (long)cm) * 16000L / (long)(dt / 1000);
+      closing[index] += (speed - closing[index]) / 4;
+    }
+    else {
+      closing[index] = 0;
+    }
+    lastCm[index] = cm;
+    lastTime[index] = sampleMicros;
+
+    if (closing[index] <= 0) {
+      timeToCollision[index] = NO_COLLISION;
+    }
+    else {
+      unsigned long ms = (unsigned long)cm * 16000UL / (unsigned long)closing[index];
+      timeToCollision[index] = ms > NO_COLLISION ? NO_COLLISION : ms;
+    }
+  }
+
+  /**
+   * Shortest time to collision over all sensors, in ms
+   */
+  template <unsigned char N>
+  unsigned int SpeedGovernor<N>::getTimeToCollision() const {
+    unsigned int shortest = NO_COLLISION;
+    for (unsigned char i = 0; i < N; i++) {
+      if (timeToCollision[i] < shortest)
+        shortest = timeToCollision[i];
+    }
+    return shortest;
+  }
+
+  /**
+   * Speed factor out of FULL_FACTOR
+   */
+  template <unsigned char N>
+  unsigned int SpeedGovernor<N>::getFactor() const {
+    unsigned int t = getTimeToCollision();
+    if (t >= fullTime)
+      return FULL_FACTOR;
+    if (t <= stopTime)
+      return 0;
+    return (unsigned long)(t - stopTime) * FULL_FACTOR / (fullTime - stopTime);
+  }
+
+  /**
+   * Governed forward speed for a requested one.  Reversing and disabled governors pass
+   * the speed through
+   */
+  template <unsigned char N>
+  int SpeedGovernor<N>::scale(int speed) const {
+    if (!enabled || speed <= minSpeed)
+      return speed;
+    return minSpeed + (int)((long)(speed - minSpeed) * getFactor() / FULL_FACTOR);
+  }
+}
+
+#endif
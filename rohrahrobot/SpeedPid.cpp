@@ -0,0 +1,121 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "SpeedPid.h"
+using namespace rohrah;
+
+#define MAX_OUTPUT 255
+
+/**
+ * Constructor.  No gains, the output is the feedforward until setGains()
+ */
+SpeedPid::SpeedPid(): kp(0), ki(0), kd(0), integral(0), previous(0) {
+  tracking.samples = 0;
+  tracking.errorSum = 0;
+  tracking.biasSum = 0;
+  tracking.maxError = 0;
+}
+
+void SpeedPid::setGains(int kp, int ki, int kd) {
+  this->kp = kp;
+  this->ki = ki;
+  this->kd = kd;
+}
+
+/**
+ * Forget the integral
+ */
+void SpeedPid::reset() {
+  integral = 0;
+}
+
+/**
+ * One control period: the motor speed to drive for the target and the speed measured
+ * over the period just gone, both in ticks/s and signed the same way as feedforward
+ */
+int SpeedPid::update(int target, int measured, int feedforward) {
+  int change = measured - previous;
+  previous = measured;
+  if (target == 0) {
+    integral = 0;
+    return 0;
+  }
+  int error = target - measured;
+  track(error);
+  long sum = integral + error;
+  if (sum > MAX_INTEGRAL)
+    sum = MAX_INTEGRAL;
+  else if (sum < -MAX_INTEGRAL)
+    sum = -MAX_INTEGRAL;
+  long output = feedforward + ((long)kp * error + ki * sum - (long)kd * change) / 256;
+  //forward only for a target ahead, backward only for one behind
+  long low = target > 0 ? 0 : -MAX_OUTPUT;
+  long high = target > 0 ? MAX_OUTPUT : 0;
+  if (output > high) {
+    output = high;
+    if (error < 0)
+      integral = sum;
+  }
+  else if (output < low) {
+    output = low;
+    if (error > 0)
+      integral = sum;
+  }
+  else {
+    integral = sum;
+  }
+  return (int)output;
+}
+
+/**
+ * The tracking error since the previous call, which starts over
+ */
+SpeedPid::Tracking SpeedPid::takeTracking() {
+  Tracking taken = tracking;
+  tracking.samples = 0;
+  tracking.errorSum = 0;
+  tracking.biasSum = 0;
+  tracking.maxError = 0;
+  return taken;
+}
+
+void SpeedPid::track(int error) {
+  if (tracking.samples == 0xFFFF)
+    return;
+  unsigned int magnitude = error < 0 ? -error : error;
+  tracking.samples++;
+  tracking.errorSum += magnitude;
+  tracking.biasSum += error;
+  if (magnitude > tracking.maxError)
+    tracking.maxError = magnitude;
+}
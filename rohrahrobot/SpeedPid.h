@@ -0,0 +1,88 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _SPEED_PID_H_
+#define _SPEED_PID_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Fixed point PID from a target wheel speed to a motor speed, -255 to 255, for a fixed
+   * control period.  Speeds are in encoder ticks/s, gains in Q8.
+   *
+   * The output is a feedforward, the speed the target was asked for with, plus the
+   * correction, so the loop only has to make up for the motor: its deadband, the battery,
+   * the load.  The derivative is of the measurement, so a new target does not kick the
+   * output, and the integral stops while the output is saturated in the direction it
+   * would push it (conditional integration), so it does not wind up when a wheel cannot
+   * keep up.  The output never reverses the motor to brake, and a target of zero lets go
+   * and starts over.
+   *
+   * It keeps the tracking error, target minus measured, over the updates with a target,
+   * for a report.
+   */
+  class SpeedPid {
+    public:
+      /**
+       * Tracking error since the last takeTracking(), in ticks/s
+       */
+      struct Tracking {
+        unsigned int samples;
+        unsigned long errorSum; //of |error|
+        long biasSum; //of error
+        unsigned int maxError;
+      };
+
+      static const long MAX_INTEGRAL = 32000; //ticks/s, summed over periods
+
+      SpeedPid();
+      void setGains(int kp, int ki, int kd);
+      void reset();
+      int update(int target, int measured, int feedforward);
+      Tracking takeTracking();
+
+    private:
+      void track(int error);
+
+      int kp; //Q8 of output per ticks/s of error
+      int ki; //Q8 of output per ticks/s of error summed over periods
+      int kd; //Q8 of output per ticks/s of change in the measured speed from one period to the next
+      long integral;
+      int previous; //measured speed at the previous update
+      Tracking tracking;
+  };
+}
+
+#endif
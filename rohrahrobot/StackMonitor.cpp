@@ -0,0 +1,115 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "StackMonitor.h"
+#include "McuLocal.h"
+
+using namespace rohrah;
+
+#ifdef __AVR__
+extern unsigned char _end; //end of .bss, where the heap starts
+extern unsigned char __stack; //RAMEND, where the stack starts
+
+/**
+ * Paint everything from the end of .bss to the top of RAM, straight out of reset.
+ * .init1 runs before the stack pointer and the zero register are set up, so it is all registers
+ */
+void paintStack() __attribute__((naked, used, section(".init1")));
+void paintStack() {
+  __asm volatile (
+    "    ldi r30, lo8(_end)\n"
+    "    ldi r31, hi8(_end)\n"
+    "    ldi r24, %0\n"
+    "    ldi r25, hi8(__stack)\n"
+    "    rjmp 2f\n"
+    "1:  st Z+, r24\n"
+    "2:  cpi r30, lo8(__stack)\n"
+    "    cpc r31, r25\n"
+    "    brlo 1b\n"
+    "    breq 1b\n"
+    :: "M" (StackMonitor::STACK_PAINT));
+}
+
+static const volatile unsigned char *const bottom = &_end;
+static const volatile unsigned char *const top = &__stack + 1;
+
+/**
+ * Nothing to do, the stack was painted at reset
+ */
+void StackMonitor::begin() {
+}
+#else
+#define PAINT_SIZE 16384
+#define RED_ZONE 256 //bytes below its frame a function may use without moving the stack pointer
+
+static MCU_LOCAL volatile unsigned char *bottom = 0;
+static MCU_LOCAL volatile unsigned char *top = 0;
+
+/**
+ * Paint PAINT_SIZE bytes of the stack below the caller's frame
+ */
+void StackMonitor::begin() {
+  top = (volatile unsigned char *)__builtin_frame_address(0) - RED_ZONE;
+  bottom = top - PAINT_SIZE;
+  for (volatile unsigned char *p = bottom; p < top; p++)
+    *p = STACK_PAINT;
+}
+#endif
+
+/**
+ * Bytes painted, the most there can ever be free
+ */
+unsigned int StackMonitor::getPainted() {
+  return top - bottom;
+}
+
+/**
+ * Bytes at the bottom that still hold the paint, the least free stack there has been.
+ * Reads every one of them, so this is for reports rather than every pass of the loop
+ */
+unsigned int StackMonitor::getMinFree() {
+  const volatile unsigned char *p = bottom;
+  while (p < top && *p == STACK_PAINT)
+    p++;
+  return p - bottom;
+}
+
+/**
+ * Print the least free stack since painting, out of the bytes painted
+ */
+void StackMonitor::report(Print &out) {
+  out.print(F("stack free "));
+  out.print(getMinFree());
+  out.print(F(" of "));
+  out.println(getPainted());
+}
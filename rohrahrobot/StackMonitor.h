@@ -0,0 +1,67 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _STACK_MONITOR_H_
+#define _STACK_MONITOR_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Stack high water mark by painting.
+   * The free RAM between the static data and the stack is filled with STACK_PAINT, and
+   * whatever the stack has never grown into still holds it.  Counting the painted bytes
+   * from the bottom up gives the least free stack there has been since, however briefly.
+   * A heap grows up from the same bottom, so on the Uno this is what the stack and the
+   * heap have left between them.
+   *
+   * On the Uno all of it is painted at reset, from .init1, before any constructor runs.
+   * Elsewhere, e.g. in the host build, begin() paints PAINT_SIZE bytes below its caller,
+   * which shows how much deeper than that the robot's loop goes.
+   *
+   * 'M' reports it over Bluetooth.  These are static methods. No need to instantiate an
+   * object of the StackMonitor class
+   */
+  class StackMonitor {
+    public:
+      static const unsigned char STACK_PAINT = 0xC5;
+
+      static void begin();
+      static unsigned int getPainted();
+      static unsigned int getMinFree();
+      static void report(Print &out);
+  };
+}
+
+#endif
@@ -0,0 +1,128 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "Telemetry.h"
+#include "Frame.h"
+#include "LinkQueue.h"
+using namespace rohrah;
+
+/**
+ * Append value as a varint, returns the new position
+ */
+static unsigned char putVarint(unsigned char *out, unsigned char pos, unsigned long value) {
+  while (value >= 0x80) {
+    out[pos++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  out[pos++] = (unsigned char)value;
+  return pos;
+}
+
+static unsigned char putZigzag(unsigned char *out, unsigned char pos, long value) {
+  return putVarint(out, pos, ((unsigned long)value << 1) ^ (value < 0 ? ~0UL : 0UL));
+}
+
+/**
+ * value held to the range of an int, so that it and its difference from another such value
+ * are at most 3 bytes as zigzag varints
+ */
+static long saturate(long value) {
+  return value > 32767L ? 32767L : value < -32768L ? -32768L : value;
+}
+
+/**
+ * Constructor
+ */
+Telemetry::Telemetry(): previousTime(0), sequence(0), sinceKey(0), needKey(true), dropped(0) {
+  for (unsigned char i = 0; i < numFields; i++)
+    previous[i] = 0;
+}
+
+/**
+ * Start over with a key frame, e.g. when telemetry is switched on.  Frames already queued
+ * still go out, the receiver can tell an old one by its sequence number
+ */
+void Telemetry::restart() {
+  needKey = true;
+}
+
+/**
+ * Queue one sample.  fields holds numFields values in field_t order.
+ * Returns false if there was no room for the frame; it is dropped and the next
+ * sample goes out as a key frame
+ */
+bool Telemetry::send(unsigned long time, const long *fields) {
+  //worst case, a delta frame: sequence, mask, 5 byte time, 3 bytes per field
+  unsigned char payload[2 + 5 + 3 * numFields];
+  static_assert(sizeof(payload) <= FRAME_MAX_PAYLOAD, "a telemetry frame has to fit the receiver's parser");
+  long values[numFields];
+  for (unsigned char i = 0; i < numFields; i++)
+    values[i] = saturate(fields[i]);
+  unsigned char frame[sizeof(payload) + FRAME_OVERHEAD];
+  unsigned char length = 0;
+  unsigned char type;
+
+  payload[length++] = sequence++;
+  if (needKey || sinceKey >= KEYFRAME_INTERVAL - 1) {
+    type = FRAME_TELEMETRY_KEY;
+    length = putVarint(payload, length, time);
+    for (unsigned char i = 0; i < numFields; i++)
+      length = putZigzag(payload, length, values[i]);
+  }
+  else {
+    type = FRAME_TELEMETRY_DELTA;
+    unsigned char mask = 0;
+    unsigned char maskPos = length++;
+    length = putVarint(payload, length, time - previousTime);
+    for (unsigned char i = 0; i < numFields; i++) {
+      if (values[i] != previous[i]) {
+        mask |= 1 << i;
+        length = putZigzag(payload, length, values[i] - previous[i]);
+      }
+    }
+    payload[maskPos] = mask;
+  }
+
+  unsigned char size = encodeFrame(frame, type, payload, length);
+  if (!LinkQueue::put(frame, size)) {
+    dropped++;
+    needKey = true;
+    return false;
+  }
+
+  sinceKey = type == FRAME_TELEMETRY_KEY ? 0 : sinceKey + 1;
+  needKey = false;
+  previousTime = time;
+  for (unsigned char i = 0; i < numFields; i++)
+    previous[i] = (int)values[i];
+  return true;
+}
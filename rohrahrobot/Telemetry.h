@@ -0,0 +1,90 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Binary telemetry stream for the Bluetooth link.
+   * Every sample is a time stamp in ms and a fixed set of integer fields.  A sample goes
+   * out as a frame (see Frame.h): a FRAME_TELEMETRY_KEY frame carries all fields, a
+   * FRAME_TELEMETRY_DELTA frame only the fields that changed since the previous sample.
+   * Every KEYFRAME_INTERVAL-th frame, and the first one after a frame had to be dropped,
+   * is a key frame, so a receiver that joins late or lost a frame is back in sync soon.
+   *
+   * Payloads start with a sequence number that counts every sample, sent or dropped.
+   * Key frame: sequence, time, then every field.  Delta frame: sequence, bitmask of the
+   * fields that follow (bit n for field n), time since the previous sample, then the
+   * difference of each field in the mask.  Times are varints, fields and differences
+   * zigzag varints, as in the Logger.  Fields are held to the range of an int, e.g. a loop
+   * time of 40ms reads 32767us, so that a frame never outgrows FRAME_MAX_PAYLOAD.
+   *
+   * Frames are queued in the LinkQueue, which writes them out a little at a time, so a
+   * sample costs the task that takes it a few tens of microseconds whatever the baud rate
+   * of the link.
+   */
+  class Telemetry {
+    public:
+      enum field_t {fieldState, fieldRawDistance, fieldDistance, fieldLeftSpeed, fieldRightSpeed,
+                    fieldLoopTime, fieldCommand, numFields};
+      static const unsigned char KEYFRAME_INTERVAL = 16;
+
+      Telemetry();
+      bool send(unsigned long time, const long *fields);
+      void restart();
+      unsigned int getDropped() const { return dropped; }
+
+    private:
+      int previous[numFields]; //as sent, held to an int
+      unsigned long previousTime;
+      unsigned char sequence;
+      unsigned char sinceKey;
+      bool needKey;
+      unsigned int dropped;
+  };
+
+  /**
+   * Stands in for Telemetry in a robot built without it: samples go nowhere
+   */
+  class NoTelemetry {
+    public:
+      bool send(unsigned long /*time*/, const long * /*fields*/) { return false; }
+      void restart() {}
+      unsigned int getDropped() const { return 0; }
+  };
+}
+
+#endif
@@ -0,0 +1,209 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "Trace.h"
+#include "Frame.h"
+#include "LinkQueue.h"
+#include "McuLocal.h"
+
+using namespace rohrah;
+
+#define MAX_RECORD_SIZE 11 //tag and two 5 byte varints
+#define MAX_REPLAY_RANDOMS 4
+
+/**
+ * If TRACING is defined, queue the trace for the Bluetooth link.  Otherwise do nothing
+ * These are static methods. No need to instantiate an object of the Trace class
+ */
+
+#ifdef TRACING
+static MCU_LOCAL unsigned char payload[FRAME_MAX_PAYLOAD] = {0};
+static MCU_LOCAL unsigned char length = 1; //payload[0] is the sequence number
+static MCU_LOCAL unsigned char receivedTag = 0; //position of the open recordReceived tag, 0 if none
+static MCU_LOCAL unsigned long lastControl = 0;
+static MCU_LOCAL unsigned long lastSample = 0;
+static MCU_LOCAL unsigned char lastState = 0xFF; //no state yet, so the first pass records it
+static MCU_LOCAL int lastLeft = 0;
+static MCU_LOCAL int lastRight = 0;
+static MCU_LOCAL unsigned int dropped = 0;
+static MCU_LOCAL long replayRandoms[MAX_REPLAY_RANDOMS];
+static MCU_LOCAL unsigned char replayRandomCount = 0;
+
+static void putVarint(unsigned long value) {
+  while (value >= 0x80) {
+    payload[length++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  payload[length++] = (unsigned char)value;
+}
+
+static void putZigzag(long value) {
+  putVarint(((unsigned long)value << 1) ^ (value < 0 ? ~0UL : 0UL));
+}
+
+/**
+ * Start a record of up to size bytes, sending the payload first if it might not fit
+ */
+static void putTag(Trace::record_t type, unsigned char argument, unsigned char size) {
+  if (length + size > FRAME_MAX_PAYLOAD)
+    Trace::flush();
+  receivedTag = 0;
+  payload[length++] = (unsigned char)(type << 5) | argument;
+}
+
+/**
+ * Queue the records so far as one frame.  A frame that does not fit is dropped, and
+ * its sequence number skipped so that the receiver can tell
+ */
+void Trace::flush() {
+  if (length <= 1)
+    return;
+  unsigned char frame[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD];
+  unsigned char size = encodeFrame(frame, FRAME_TRACE, payload, length);
+  if (!LinkQueue::put(frame, size))
+    dropped++;
+  payload[0]++;
+  length = 1;
+  receivedTag = 0;
+}
+
+/**
+ * A control pass starts at time (ms)
+ */
+void Trace::control(unsigned long time) {
+  unsigned long elapsed = time - lastControl;
+  lastControl = time;
+  if (elapsed < MAX_ARGUMENT) {
+    putTag(recordControl, elapsed, 1);
+  }
+  else {
+    putTag(recordControl, MAX_ARGUMENT, MAX_RECORD_SIZE);
+    putVarint(elapsed);
+  }
+}
+
+/**
+ * Sensor index took a sample of cm at time (us).  echo is false if it saw nothing within range
+ */
+void Trace::sample(unsigned char index, unsigned int cm, bool echo, unsigned long time) {
+  putTag(recordSample, (index << 1) | (echo ? 1 : 0), MAX_RECORD_SIZE);
+  putVarint(cm);
+  putVarint(time - lastSample);
+  lastSample = time;
+}
+
+/**
+ * A byte was read from the remote control.  Bytes read one after the other share a record
+ */
+void Trace::received(unsigned char b) {
+  if (receivedTag == 0 || (payload[receivedTag] & MAX_ARGUMENT) == MAX_ARGUMENT || length >= FRAME_MAX_PAYLOAD) {
+    putTag(recordReceived, 0, 2);
+    receivedTag = length - 1;
+  }
+  payload[receivedTag]++;
+  payload[length++] = b;
+}
+
+/**
+ * random(low, high), recorded.  When replaying, the recorded value instead
+ */
+long Trace::random(long low, long high) {
+  long value;
+  if (replayRandomCount > 0) {
+    value = replayRandoms[0];
+    replayRandomCount--;
+    for (unsigned char i = 0; i < replayRandomCount; i++)
+      replayRandoms[i] = replayRandoms[i + 1];
+  }
+  else {
+    value = ::random(low, high);
+  }
+  putTag(recordRandom, 0, MAX_RECORD_SIZE);
+  putZigzag(value);
+  return value;
+}
+
+/**
+ * A control pass ends with the robot in state and the motors at left and right.  Only changes are recorded
+ */
+void Trace::outputs(unsigned char state, int left, int right) {
+  if (state != lastState) {
+    putTag(recordState, state & MAX_ARGUMENT, 1);
+    lastState = state;
+  }
+  if (left != lastLeft || right != lastRight) {
+    putTag(recordMotors, 0, MAX_RECORD_SIZE);
+    putZigzag(left - lastLeft);
+    putZigzag(right - lastRight);
+    lastLeft = left;
+    lastRight = right;
+  }
+}
+
+/**
+ * Number of frames that were dropped because the link could not keep up
+ */
+unsigned int Trace::getDropped() {
+  return dropped;
+}
+
+void Trace::replayRandom(long value) {
+  if (replayRandomCount < MAX_REPLAY_RANDOMS)
+    replayRandoms[replayRandomCount++] = value;
+}
+#else
+void Trace::control(unsigned long /*time*/) {
+}
+
+void Trace::sample(unsigned char /*index*/, unsigned int /*cm*/, bool /*echo*/, unsigned long /*time*/) {
+}
+
+void Trace::received(unsigned char /*b*/) {
+}
+
+long Trace::random(long low, long high) {
+  return ::random(low, high);
+}
+
+void Trace::outputs(unsigned char /*state*/, int /*left*/, int /*right*/) {
+}
+
+void Trace::flush() {
+}
+
+unsigned int Trace::getDropped() {
+  return 0;
+}
+
+void Trace::replayRandom(long /*value*/) {
+}
+#endif
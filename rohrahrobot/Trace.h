@@ -0,0 +1,95 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+// Uncomment to record the robot's inputs for replay on the host.  Costs about 260 bytes of SRAM,
+// most of it the larger LinkQueue
+//#define TRACING
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Input trace for deterministic replay.
+   * Records everything from outside that the robot's decisions depend on: the time of
+   * every control pass, every distance sample, every byte received from the remote
+   * control and every random number drawn, plus the state and motor outputs each control
+   * pass ends with, so that a replay can be checked against them.  Scheduling jitter is
+   * an input like any other: a replay runs the passes in the recorded order with the
+   * recorded times, so the scheduler itself is not replayed.  The replayer is tracereplay
+   * in host/tools.
+   *
+   * The trace goes out on the Bluetooth link in FRAME_TRACE frames (see Frame.h).  A
+   * payload starts with a sequence number and holds whole records, each a tag byte with
+   * the record type in the top 3 bits and a small argument in the low 5 bits:
+   *   recordControl  argument: ms since the previous control pass, or 31 and a varint
+   *   recordSample   argument: sensor index << 1 | echo.  Then cm and us since the
+   *                  previous sample as varints
+   *   recordReceived argument: number of bytes, which follow
+   *   recordRandom   zigzag varint value
+   *   recordState    argument: the new state
+   *   recordMotors   zigzag varint changes of the left and right output
+   * A frame goes out once its payload is full, so the last few records lag behind.
+   * Frames share the LinkQueue with telemetry.  Those that do not fit are dropped and leave
+   * a gap in the sequence, which is where a replay has to stop.  At 9600 baud on
+   * SoftwareSerial the link is too slow for a robot that is busy, use the hardware UART.
+   *
+   * The script task of a motion script is not recorded, so a replay only holds up to where
+   * a script starts.
+   *
+   * If TRACING is not defined every call does nothing, and random() just draws.
+   * These are static methods. No need to instantiate an object of the Trace class
+   */
+  class Trace {
+    public:
+      enum record_t {recordControl, recordSample, recordReceived, recordRandom, recordState, recordMotors, numRecords};
+      static const unsigned char MAX_ARGUMENT = 31;
+
+      static void control(unsigned long time);
+      static void sample(unsigned char index, unsigned int cm, bool echo, unsigned long time);
+      static void received(unsigned char b);
+      static long random(long low, long high);
+      static void outputs(unsigned char state, int left, int right);
+      static void flush();
+      static unsigned int getDropped();
+
+      /**
+       * Replay only: hand out value from the next random() instead of drawing one
+       */
+      static void replayRandom(long value);
+  };
+}
+
+#endif
@@ -0,0 +1,101 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _TRANSPORT_H_
+#define _TRANSPORT_H_
+
+// Uncomment if the Bluetooth module is wired to the hardware UART (pins 0 and 1) instead.
+// Its baud rate has to be set to match with the module's AT+UART command
+//#define BT_HARDWARE_UART
+
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+
+namespace rohrah {
+
+  /**
+   * The byte link to the remote control.
+   * A Stream, so everything that can print can print to it, plus begin() and an
+   * availableForWrite() that writers use to avoid blocking the loop
+   */
+  class Transport : public Stream {
+    public:
+      virtual ~Transport() {}
+      virtual void begin(unsigned long baud) = 0;
+  };
+
+  /**
+   * Bluetooth module on the hardware UART (pins 0 and 1).
+   * Receiving and sending are interrupt driven through 64 byte ring buffers, so a byte
+   * costs the loop a few microseconds instead of the millisecond SoftwareSerial spends
+   * with interrupts off, and the link can run at 115200 baud.
+   * The UART is shared with the USB port, which the Logger writes to.  Its binary records
+   * would go out on the link between the frames, so there is no LOGGING in this wiring
+   * (see Logger.h)
+   */
+  class HardwareSerialTransport : public Transport {
+    public:
+      HardwareSerialTransport(HardwareSerial &port): serial(port) {}
+      void begin(unsigned long baud) { serial.begin(baud); }
+      int available() { return serial.available(); }
+      int read() { return serial.read(); }
+      int peek() { return serial.peek(); }
+      int availableForWrite() { return serial.availableForWrite(); }
+      size_t write(uint8_t b) { return serial.write(b); }
+      using Print::write;
+
+    private:
+      HardwareSerial &serial;
+  };
+
+  /**
+   * Bluetooth module on any two pins through SoftwareSerial, the original wiring.
+   * Every byte sent blocks for its full frame time with interrupts off, so writers that
+   * must not stall the loop are allowed one byte at a time
+   */
+  class SoftwareSerialTransport : public Transport {
+    public:
+      SoftwareSerialTransport(SoftwareSerial &port): serial(port) {}
+      void begin(unsigned long baud) { serial.begin(baud); }
+      int available() { return serial.available(); }
+      int read() { return serial.read(); }
+      int peek() { return serial.peek(); }
+      int availableForWrite() { return 1; }
+      size_t write(uint8_t b) { return serial.write(b); }
+      using Print::write;
+
+    private:
+      SoftwareSerial &serial;
+  };
+}
+
+#endif
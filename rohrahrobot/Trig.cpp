@@ -0,0 +1,55 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "Trig.h"
+
+#define SINE_ROW(i) sineEntry(i), sineEntry(i + 1), sineEntry(i + 2), sineEntry(i + 3), \
+                    sineEntry(i + 4), sineEntry(i + 5), sineEntry(i + 6), sineEntry(i + 7)
+
+namespace rohrah {
+
+  static_assert(SINE_STEPS == 64, "SINE_TABLE is written out as 8 rows of 8");
+  static_assert(sineEntry(SINE_STEPS) == TRIG_ONE, "sineSeries has too few terms");
+  static_assert(binaryAngle(90) == 16384, "binaryAngle is worked out by the compiler");
+
+  const int SINE_TABLE[SINE_STEPS + 1] PROGMEM = {
+    SINE_ROW(0),
+    SINE_ROW(8),
+    SINE_ROW(16),
+    SINE_ROW(24),
+    SINE_ROW(32),
+    SINE_ROW(40),
+    SINE_ROW(48),
+    SINE_ROW(56),
+    sineEntry(SINE_STEPS)
+  };
+}
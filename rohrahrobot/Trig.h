@@ -0,0 +1,117 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef _TRIG_H_
+#define _TRIG_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Integer trigonometry on binary angles: a full turn is 65536, so angles wrap for free
+   * in a 16 bit unsigned int and 90 degrees is 16384.  Results are Q1.14, 16384 standing
+   * for 1.  A quarter wave table with 64 steps per quadrant (1.4 degrees) lives in flash
+   * and sine() interpolates between its entries, to within 4/16384 of the true value.
+   *
+   * The table is worked out by the compiler (see sineEntry), so neither the sketch nor
+   * the source carries any floating point code or magic numbers for it.
+   */
+  #define ANGLE_QUARTER_TURN 16384U
+  #define TRIG_ONE 16384
+  #define SINE_STEPS 64 //table entries per quadrant, plus one for 90 degrees
+
+  extern const int SINE_TABLE[SINE_STEPS + 1] PROGMEM;
+
+  /**
+   * Taylor series of sin(x) from the term given on, for 0 <= x <= pi/2.  Compile time only
+   */
+  constexpr double sineSeries(double x, double term, int n) {
+    return n > 12 ? 0 : term + sineSeries(x, -term * x * x / ((2 * n + 2) * (2 * n + 3)), n + 1);
+  }
+
+  /**
+   * SINE_TABLE[i], sin(i / SINE_STEPS * 90 degrees) in Q1.14, rounded.  Compile time only
+   */
+  constexpr int sineEntry(int i) {
+    return (int)(sineSeries(i * 3.14159265358979 / (2 * SINE_STEPS), i * 3.14159265358979 / (2 * SINE_STEPS), 0)
+                 * TRIG_ONE + 0.5);
+  }
+
+  /**
+   * Binary angle for a whole number of degrees, at compile time if deg is a constant
+   */
+  constexpr unsigned int binaryAngle(int deg) {
+    return (unsigned int)((long)deg * 65536L / 360);
+  }
+
+  /**
+   * sin(angle) in Q1.14.  Two table reads and a 16 bit multiply
+   */
+  inline int sine(unsigned int angle) {
+    unsigned char quadrant = (angle >> 14) & 3;
+    unsigned int offset = angle & (ANGLE_QUARTER_TURN - 1);
+    if (quadrant & 1)
+      offset = ANGLE_QUARTER_TURN - offset; //second and fourth quadrants run backwards
+    unsigned char step = offset >> 8;
+    int value = (int)pgm_read_word(&SINE_TABLE[step]);
+    if (step < SINE_STEPS) {
+      //the table rises by at most 402 per step, so 7 bits of the fraction keep this within an unsigned int
+      unsigned int rise = pgm_read_word(&SINE_TABLE[step + 1]) - value;
+      value += (rise * ((offset >> 1) & 0x7F)) >> 7;
+    }
+    return quadrant & 2 ? -value : value;
+  }
+
+  /**
+   * cos(angle) in Q1.14
+   */
+  inline int cosine(unsigned int angle) {
+    return sine(angle + ANGLE_QUARTER_TURN);
+  }
+
+  /**
+   * atan(ratio) as a signed binary angle, for any ratio in Q.14.  x / (1 + 0.28 x^2) up to
+   * 45 degrees either way and a quarter turn less atan(1 / x) beyond, to within 0.3 degrees
+   */
+  inline int arctangent(long ratio) {
+    if (ratio > TRIG_ONE || ratio < -TRIG_ONE) {
+      int rest = arctangent((1L << 28) / ratio);
+      return ratio > 0 ? (int)ANGLE_QUARTER_TURN - rest : -(int)ANGLE_QUARTER_TURN - rest;
+    }
+    long x = ratio;
+    //radians to binary angle is 65536 / 2 pi = 10430, and 0.28 in Q1.14 is 4588
+    return (int)(x * 10430L / (TRIG_ONE + ((((x * x) >> 14) * 4588L) >> 14)));
+  }
+}
+
+#endif
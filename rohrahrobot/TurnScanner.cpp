@@ -0,0 +1,154 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "TurnScanner.h"
+using namespace rohrah;
+
+#define UNSEEN 0xFF
+#define BIN_SHIFT 12 //65536 / NUM_BINS
+#define HALF_BIN 0x800
+#define FULL_TURN 65536L
+#define REVERSE_COST 8192 //binary angle, 45 degrees: the motors take about 250ms to go from full one way to full the other
+
+/**
+ * Constructor.  Idle until start()
+ */
+TurnScanner::TurnScanner(unsigned char range, unsigned char tolerance): range(range < UNSEEN ? range : UNSEEN - 1),
+                                                                        tolerance(tolerance), phase(phaseIdle), left(false),
+                                                                        lastHeading(0), turned(0), goal(0) {
+}
+
+/**
+ * Start scanning arc degrees, up to 360, from heading, spinning left (counter clockwise)
+ * or right.  Returns false for an arc of 0, the robot should turn some other way then
+ */
+bool TurnScanner::start(unsigned int heading, unsigned int arc, bool left) {
+  if (arc == 0)
+    return false;
+  for (unsigned char i = 0; i < NUM_BINS; i++)
+    bins[i] = UNSEEN;
+  this->left = left;
+  lastHeading = heading;
+  turned = 0;
+  goal = (unsigned long)(arc < 360 ? arc : 360) * FULL_TURN / 360;
+  phase = phaseScanning;
+  return true;
+}
+
+/**
+ * A sample taken looking towards bearing, an absolute heading.  Only counts while scanning
+ */
+void TurnScanner::add(unsigned int bearing, unsigned int cm, bool echo) {
+  if (phase != phaseScanning)
+    return;
+  unsigned char bin = ((bearing + HALF_BIN) & 0xFFFF) >> BIN_SHIFT;
+  unsigned char seen = !echo || cm > range ? range : (unsigned char)cm;
+  if (seen < bins[bin]) //anything seen is less than UNSEEN
+    bins[bin] = seen;
+}
+
+/**
+ * Once per control pass with the dead reckoned heading.  Returns true while the robot
+ * should go on spinning, in the direction isLeft() says, false when it faces the way it
+ * chose or the scanner is idle
+ */
+bool TurnScanner::update(unsigned int heading) {
+  if (phase == phaseIdle)
+    return false;
+  int step = (int)(short)(heading - lastHeading);
+  lastHeading = heading;
+  turned += left ? step : -step;
+  if (turned + HALF_BIN < (long)goal)
+    return true;
+  if (phase == phaseScanning) {
+    choose(heading);
+    if (turned + HALF_BIN < (long)goal)
+      return true;
+  }
+  phase = phaseIdle;
+  return false;
+}
+
+/**
+ * Pick the heading to leave by and set up the spin there
+ */
+void TurnScanner::choose(unsigned int heading) {
+  unsigned char best = 0;
+  for (unsigned char i = 0; i < NUM_BINS; i++) {
+    unsigned char open = openness(i);
+    if (open != UNSEEN && open > best)
+      best = open;
+  }
+  long cheapest = FULL_TURN * 2;
+  long rotation = 0;
+  bool way = left;
+  for (unsigned char i = 0; i < NUM_BINS; i++) {
+    unsigned char open = openness(i);
+    if (open == UNSEEN || open + tolerance < best)
+      continue;
+    unsigned int target = (unsigned int)i << BIN_SHIFT;
+    long on = (long)((left ? target - heading : heading - target) & 0xFFFF);
+    long back = FULL_TURN - on;
+    if (on < cheapest) {
+      cheapest = on;
+      rotation = on;
+      way = left;
+    }
+    if (back + REVERSE_COST < cheapest) {
+      cheapest = back + REVERSE_COST;
+      rotation = back;
+      way = !left;
+    }
+  }
+  phase = phaseTurning;
+  turned = 0;
+  goal = rotation; //0 if nothing was seen, the robot stays as it is
+  left = way;
+}
+
+/**
+ * The closest echo in bin and the bins either side, UNSEEN if bin was not seen.  Unseen
+ * neighbours, at the ends of a scan shorter than a full turn, do not count
+ */
+unsigned char TurnScanner::openness(unsigned char bin) const {
+  unsigned char open = bins[bin];
+  if (open == UNSEEN)
+    return UNSEEN;
+  unsigned char before = bins[(bin + NUM_BINS - 1) % NUM_BINS];
+  unsigned char after = bins[(bin + 1) % NUM_BINS];
+  if (before < open)
+    open = before;
+  if (after < open)
+    open = after;
+  return open;
+}
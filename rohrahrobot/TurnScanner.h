@@ -0,0 +1,84 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _TURN_SCANNER_H_
+#define _TURN_SCANNER_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * Finds the way out of a turn by looking rather than by chance.  While the robot spins
+   * in place through arc degrees, every sample of every sensor goes into a histogram of
+   * NUM_BINS headings, 22.5 degrees each, holding the closest echo seen that way, or range
+   * for none.  When the arc is done the robot commits to the heading whose bin and its two
+   * neighbours (the robot is wider than a beam) are the most open, and of those as open
+   * as the best to within tolerance cm, to the one it gets to soonest: on in the direction
+   * it spins, or back the other way if that is shorter by more than the time it takes the
+   * motors to reverse.  update() says whether it is still spinning and isLeft() which way.
+   *
+   * Headings are binary angles, 65536 to a full turn, as Odometry keeps them.  The heading
+   * is only as good as dead reckoning, so a turn that ends facing something close still
+   * goes on turning, see Robot::doneTurning()
+   */
+  class TurnScanner {
+    public:
+      static const unsigned char NUM_BINS = 16;
+
+      TurnScanner(unsigned char range, unsigned char tolerance);
+      bool start(unsigned int heading, unsigned int arc, bool left);
+      void add(unsigned int bearing, unsigned int cm, bool echo);
+      bool update(unsigned int heading);
+      void stop() { phase = phaseIdle; }
+      bool isActive() const { return phase != phaseIdle; }
+      bool isScanning() const { return phase == phaseScanning; }
+      bool isLeft() const { return left; }
+
+    private:
+      enum phase_t {phaseIdle, phaseScanning, phaseTurning};
+      void choose(unsigned int heading);
+      unsigned char openness(unsigned char bin) const;
+
+      unsigned char range; //cm, what no echo counts as, at most 254
+      unsigned char tolerance; //cm
+      unsigned char phase;
+      bool left; //spinning counter clockwise
+      unsigned int lastHeading;
+      long turned; //binary angle spun through since the scan or the final turn started
+      unsigned long goal; //binary angle to spin through
+      unsigned char bins[NUM_BINS]; //cm, closest echo, UNSEEN if no sample went there
+  };
+}
+
+#endif
@@ -0,0 +1,99 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include "WheelEncoder.h"
+using namespace rohrah;
+
+/**
+ * Constructor
+ */
+WheelEncoder::WheelEncoder(int pin): pin(pin), level(LOW), ticks(0), lastTick(0), sampledTicks(0), sampledTime(0), speed(0) {
+}
+
+/**
+ * Set the pin up and take the level it starts at
+ */
+void WheelEncoder::begin() {
+  pinMode(pin, INPUT_PULLUP);
+  level = digitalRead(pin);
+  sampledTime = lastTick = micros();
+}
+
+/**
+ * Count a tick if the level changed since the previous sample.  Call from the timer interrupt
+ */
+void WheelEncoder::sample(unsigned long currentMicros) {
+  unsigned char now = digitalRead(pin);
+  if (now == level)
+    return;
+  level = now;
+  ticks++;
+  lastTick = currentMicros;
+}
+
+/**
+ * Speed in ticks/s since the previous call: the ticks since then over the time from the
+ * last tick before it to the last one now.  Without a tick since, the wheel can be no
+ * faster than one tick from then until now, and after STOPPED_TIME it is stopped.
+ * Call from the timer interrupt, at a steady rate
+ */
+unsigned int WheelEncoder::rate(unsigned long currentMicros) {
+  unsigned int count = ticks - sampledTicks;
+  if (count > 0) {
+    unsigned long span = lastTick - sampledTime;
+    unsigned long perSecond = span > 0 ? count * 1000000UL / span : 0xFFFF;
+    speed = perSecond > 0xFFFF ? 0xFFFF : perSecond;
+    sampledTicks = ticks;
+    sampledTime = lastTick;
+  }
+  else {
+    unsigned long since = currentMicros - sampledTime;
+    if (since >= STOPPED_TIME) {
+      speed = 0;
+      sampledTime = currentMicros - STOPPED_TIME; //the first tick from standstill is not taken for a crawl
+    }
+    else if (since > 0 && 1000000UL / since < speed)
+      speed = 1000000UL / since;
+  }
+  return speed;
+}
+
+/**
+ * Ticks counted since begin(), wrapping at 65536
+ */
+unsigned int WheelEncoder::getTicks() const {
+  noInterrupts();
+  unsigned int count = ticks;
+  interrupts();
+  return count;
+}
@@ -0,0 +1,76 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _WHEEL_ENCODER_H_
+#define _WHEEL_ENCODER_H_
+
+#include <Arduino.h>
+
+namespace rohrah {
+
+  /**
+   * A single channel wheel encoder, e.g. a slotted disk in an optical fork.  Every edge is
+   * a tick, both ways, so a 20 slot disk gives 40 ticks a turn.  One channel cannot tell
+   * the direction, that is up to whoever drives the wheel.
+   *
+   * The encoder is sampled from a timer interrupt (see WheelSpeedControl) instead of
+   * counted on pin change: SoftwareSerial takes every pin change vector of the ATmega, and
+   * the only external interrupt left, INT1, is one pin.  At a sample a millisecond the
+   * wheel can turn at 500 ticks a second, several times what it does, and sampling
+   * filters contact bounce for free.
+   *
+   * The time of the latest tick is kept too, so rate() measures the speed over whole tick
+   * intervals, far finer than counting ticks per period at a few dozen ticks a second.
+   */
+  class WheelEncoder {
+    public:
+      static const unsigned long STOPPED_TIME = 250000; //us without a tick that count as standing still
+
+      WheelEncoder(int pin);
+      void begin();
+      void sample(unsigned long currentMicros);
+      unsigned int rate(unsigned long currentMicros);
+      unsigned int getTicks() const;
+
+    private:
+      unsigned char pin;
+      unsigned char level; //at the previous sample
+      unsigned int ticks;
+      unsigned long lastTick; //us
+      unsigned int sampledTicks; //ticks and lastTick at the previous rate()
+      unsigned long sampledTime;
+      unsigned int speed; //ticks/s at the previous rate()
+  };
+}
+
+#endif
@@ -0,0 +1,164 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#include <TimerOne.h>
+#include "WheelSpeedControl.h"
+using namespace rohrah;
+
+MCU_LOCAL WheelSpeedControl *WheelSpeedControl::active = 0;
+
+/**
+ * Constructor.  maxRate in ticks/s, sampleInterval in us and controlInterval in ms.
+ * Nothing runs until start()
+ */
+WheelSpeedControl::WheelSpeedControl(int leftPin, int rightPin, unsigned int maxRate, unsigned int sampleInterval, unsigned int controlInterval):
+                  left(leftPin), right(rightPin), maxRate(maxRate), sampleInterval(sampleInterval),
+                  samplesPerControl(controlInterval * 1000UL / sampleInterval), samples(0), running(false) {
+}
+
+/**
+ * Destructor.  Lets go of the timer
+ */
+WheelSpeedControl::~WheelSpeedControl() {
+  if (active == this) {
+    stop();
+    Timer1.detachInterrupt();
+    active = 0;
+  }
+}
+
+/**
+ * Gains of both wheels' PIDs, see SpeedPid
+ */
+void WheelSpeedControl::setGains(int kp, int ki, int kd) {
+  noInterrupts();
+  left.pid.setGains(kp, ki, kd);
+  right.pid.setGains(kp, ki, kd);
+  interrupts();
+}
+
+/**
+ * Take over the motors.  The first call sets up the encoders and the timer, which keeps
+ * sampling the encoders from then on.  Returns false if another WheelSpeedControl has the timer
+ */
+bool WheelSpeedControl::start(Motor &leftMotor, Motor &rightMotor) {
+  if (active != this) {
+    if (active != 0)
+      return false;
+    active = this;
+    left.encoder.begin();
+    right.encoder.begin();
+    Timer1.initialize(sampleInterval);
+    Timer1.attachInterrupt(timerInterrupt);
+  }
+  noInterrupts();
+  left.motor = &leftMotor;
+  right.motor = &rightMotor;
+  left.pid.reset();
+  right.pid.reset();
+  running = true;
+  interrupts();
+  leftMotor.setClosedLoop(true);
+  rightMotor.setClosedLoop(true);
+  return true;
+}
+
+/**
+ * Hand the motors back to open loop, e.g. for calibrating them
+ */
+void WheelSpeedControl::stop() {
+  noInterrupts();
+  running = false;
+  interrupts();
+  if (left.motor != 0)
+    left.motor->setClosedLoop(false);
+  if (right.motor != 0)
+    right.motor->setClosedLoop(false);
+}
+
+/**
+ * Timer1 interrupt: sample the encoders, and once a control period drive the motors
+ */
+void WheelSpeedControl::timerInterrupt() {
+  WheelSpeedControl *c = active;
+  unsigned long now = micros();
+  c->left.encoder.sample(now);
+  c->right.encoder.sample(now);
+  if (++c->samples < c->samplesPerControl)
+    return;
+  c->samples = 0;
+  c->control(c->left, now);
+  c->control(c->right, now);
+}
+
+/**
+ * One control period of a wheel.  The encoder gives the speed, the direction is the one
+ * the wheel is being driven in
+ */
+void WheelSpeedControl::control(Wheel &wheel, unsigned long currentMicros) {
+  unsigned int rate = wheel.encoder.rate(currentMicros);
+  if (!running || !wheel.motor->isClosedLoop())
+    return;
+  int setpoint = wheel.motor->getOutput();
+  int driven = wheel.motor->getDriven();
+  int speed = rate > 0x7FFF ? 0x7FFF : rate;
+  int measured = driven < 0 || (driven == 0 && setpoint < 0) ? -speed : speed;
+  int target = (long)setpoint * maxRate / 255;
+  wheel.motor->drive(wheel.pid.update(target, measured, setpoint));
+}
+
+/**
+ * Print a line per wheel of the tracking error since the last report, in ticks/s: the
+ * control periods with a target, the mean and largest error, and the mean signed error,
+ * positive for a wheel slower than asked for
+ */
+void WheelSpeedControl::report(Print &out) {
+  out.println(F("wheel periods error max bias"));
+  report(out, 'L', left);
+  report(out, 'R', right);
+}
+
+void WheelSpeedControl::report(Print &out, char name, Wheel &wheel) {
+  noInterrupts();
+  SpeedPid::Tracking t = wheel.pid.takeTracking();
+  interrupts();
+  out.print(name);
+  out.print(' ');
+  out.print(t.samples);
+  out.print(' ');
+  out.print(t.samples ? t.errorSum / t.samples : 0);
+  out.print(' ');
+  out.print(t.maxError);
+  out.print(' ');
+  out.println(t.samples ? t.biasSum / (long)t.samples : 0);
+}
@@ -0,0 +1,106 @@
+//
+//  Robot Car using Arduino Uno
+//
+//  Author: Kiran Hegde
+//  http://www.rohrah.com/
+//  Copyright (c) 2016 
+//
+//  My code utilizes ideas and code from http://blog.miguelgrinberg.com/
+//  and therefore I have included the relevant license below
+//
+//
+// Michelino
+// Robot Vehicle firmware for the Arduino platform
+// Copyright (c) 2013 by Miguel Grinberg
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN
+// AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+
+#ifndef _WHEEL_SPEED_CONTROL_H_
+#define _WHEEL_SPEED_CONTROL_H_
+
+#include <Arduino.h>
+#include "Motor.h"
+#include "WheelEncoder.h"
+#include "SpeedPid.h"
+#include "McuLocal.h"
+
+namespace rohrah {
+
+  /**
+   * Closed loop speed control of both wheels, from an encoder per wheel.
+   * Once started, Timer1 interrupts every sampleInterval: the encoders are sampled, and
+   * every controlInterval a SpeedPid per wheel drives its motor toward the motor's
+   * output, the speed asked for after ramping, scaled so 255 is maxRate ticks/s.  That
+   * way a speed means the same on both wheels and whatever the battery, as long as
+   * maxRate is under what the weaker wheel does at full PWM.  The motors are in closed
+   * loop (see Motor::setClosedLoop) while it runs.
+   *
+   * 'W' reports the tracking error of each wheel.
+   */
+  class WheelSpeedControl {
+    public:
+      WheelSpeedControl(int leftPin, int rightPin, unsigned int maxRate, unsigned int sampleInterval, unsigned int controlInterval);
+      ~WheelSpeedControl();
+      void setGains(int kp, int ki, int kd);
+      bool start(Motor &left, Motor &right);
+      void stop();
+      bool isRunning() const { return running; }
+      unsigned int getMaxRate() const { return maxRate; }
+      void report(Print &out);
+
+    private:
+      struct Wheel {
+        Wheel(int pin): encoder(pin), motor(0) {}
+        WheelEncoder encoder;
+        SpeedPid pid;
+        Motor *motor;
+      };
+
+      static void timerInterrupt();
+      static MCU_LOCAL WheelSpeedControl *active;
+
+      void control(Wheel &wheel, unsigned long currentMicros);
+      void report(Print &out, char name, Wheel &wheel);
+
+      Wheel left;
+      Wheel right;
+      unsigned int maxRate; //ticks/s at speed 255
+      unsigned int sampleInterval; //us between timer interrupts
+      unsigned char samplesPerControl;
+      unsigned char samples; //since the last control period
+      volatile bool running;
+  };
+
+  /**
+   * Stands in for WheelSpeedControl in a robot built without wheel encoders.  The motors
+   * stay in open loop and 'W' only gets a report saying so
+   */
+  class NoWheelSpeedControl {
+    public:
+      NoWheelSpeedControl(int /*leftPin*/, int /*rightPin*/, unsigned int /*maxRate*/, unsigned int /*sampleInterval*/, unsigned int /*controlInterval*/) {}
+      void setGains(int /*kp*/, int /*ki*/, int /*kd*/) {}
+      bool start(Motor &/*left*/, Motor &/*right*/) { return false; }
+      void stop() {}
+      bool isRunning() const { return false; }
+      unsigned int getMaxRate() const { return 0; }
+      void report(Print &out) { out.println(F("speed control not built in")); }
+  };
+}
+
+#endif
@@ -30,25 +30,43 @@
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 
-#define LOGGING
-
 #include <SoftwareSerial.h>
 #include "Robot.h"
 
-#define BT_RX_PIN 16 //pin A3     
-#define BT_TX_PIN 17 //pin A4
+//The robot to build, see RobotConfig.h.  LeanConfig leaves out the map, motor calibration,
+//telemetry, wheel encoders, motion scripts and the link monitor, BasicConfig also the side
+//sensors and the speed governor
+#ifndef ROBOT_CONFIG
+#define ROBOT_CONFIG rohrah::StandardConfig
+#endif
+typedef ROBOT_CONFIG Config;
+
+//The wiring of the Bluetooth module is set in Transport.h, and with it whether there is a log
+#ifdef BT_HARDWARE_UART
+#define BT_BAUD 115200
+#else
+#define BT_BAUD 9600
+#endif
 
 //Global Serial objects
-SoftwareSerial BTSerial(BT_RX_PIN, BT_TX_PIN);
-rohrah::Robot myRobot(&BTSerial);
+#ifdef BT_HARDWARE_UART
+rohrah::HardwareSerialTransport btLink(Serial);
+#else
+SoftwareSerial BTSerial(Config::BT_RX_PIN, Config::BT_TX_PIN);
+rohrah::SoftwareSerialTransport btLink(BTSerial);
+#endif
+rohrah::Robot<Config> myRobot(&btLink);
 
 void setup() {
   // setup code to run once:
+#ifndef BT_HARDWARE_UART
   Serial.begin(9600);
-  BTSerial.begin(9600);
+#endif
+  btLink.begin(BT_BAUD);
+  myRobot.begin();
 }
 
 void loop() {
   // main code here, to run repeatedly:
   myRobot.run();
-}
+}